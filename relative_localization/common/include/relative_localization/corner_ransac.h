@@ -0,0 +1,129 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef CORNER_RANSAC_H
+#define CORNER_RANSAC_H
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include <relative_localization/random_generator.h>
+
+
+// RANSAC estimator for an L-shaped corner, i.e. two perpendicular lines (front wall and side wall) sharing the corner point.
+// A hypothesis is drawn from a minimal set of three points: two points of the front wall point set define the front wall line,
+// one point of the side wall point set fixes the perpendicular side wall line. Front and side points are scored against their
+// respective line in one pass (with the same early termination and adaptive iteration count as LineRansac).
+// Each point supports at most one wall: side wall points closer than 2*max_inlier_distance to the front wall line are ignored,
+// like the front wall points removed from the side wall search of the sequential estimation.
+// The best hypothesis is refined by a joint least squares fit of both lines under the perpendicularity constraint (closed form).
+// Lines are represented as [x0, y0, n0.x, n0.y] (point on line and normalized normal direction).
+class CornerRansac
+{
+public:
+
+	CornerRansac();
+
+	// front_points / side_points = points of the front wall / side wall search areas (may contain clutter, side_points may contain front wall points)
+	// inlier_ratio = the (minimum expected) ratio of line inliers in each point set, defines the maximum number of iterations
+	// min_front_normal_x = minimum absolute x-component of the front wall normal (e.g. 0.707 = at most 45 deg to the robot's x-axis)
+	// returns false if no corner could be fit
+	bool fitCorner(const std::vector<cv::Point2d>& front_points, const std::vector<cv::Point2d>& side_points, cv::Vec4d& line_front, cv::Vec4d& line_side,
+			const double inlier_ratio, const double success_probability, const double max_inlier_distance, const double min_front_normal_x);
+
+	void setSeed(const uint64_t seed, const uint64_t stream=0) { random_generator_.setSeed(seed, stream); }
+
+	// number of hypotheses tested in the last call of fitCorner
+	int getIterations() const { return iterations_; }
+
+	// number of front and side wall points used for the least squares fit of the last corner
+	int getFrontInliers() const { return front_inliers_; }
+	int getSideInliers() const { return side_inliers_; }
+
+	// uncertainty of the last corner, see LineRansac: position variances of the lines across the walls at their line points [x0, y0],
+	// in [m^2], and the variance of the common direction of both lines, in [rad^2]
+	double getFrontOffsetVariance() const { return front_offset_variance_; }
+	double getSideOffsetVariance() const { return side_offset_variance_; }
+	double getAngleVariance() const { return angle_variance_; }
+
+
+protected:
+
+	// true if the side wall point (x, y) is within max_inlier_distance of the side line t*p = b and not close to the front line n0*p = a
+	bool isSideInlier(const double x, const double y, const cv::Point2d& n0, const double a, const double b, const double max_inlier_distance) const;
+
+	// least squares fit of both lines to the inliers of the corner model (front normal n0, front line n0*p = a, side line t*p = b with t = [-n0.y, n0.x]),
+	// returns false if there are not enough inliers
+	bool refineCorner(cv::Point2d& n0, double& a, double& b, const double max_inlier_distance, cv::Vec4d& line_front, cv::Vec4d& line_side);
+
+	std::vector<double> front_x_;
+	std::vector<double> front_y_;
+	std::vector<double> side_x_;
+	std::vector<double> side_y_;
+
+	int iterations_;
+	int front_inliers_;
+	int side_inliers_;
+	double front_offset_variance_;
+	double side_offset_variance_;
+	double angle_variance_;
+	RandomGenerator random_generator_;
+};
+
+
+#endif	// CORNER_RANSAC_H
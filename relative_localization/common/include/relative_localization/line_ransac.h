@@ -0,0 +1,129 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef LINE_RANSAC_H
+#define LINE_RANSAC_H
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include <relative_localization/random_generator.h>
+
+
+// RANSAC line estimator for 2d point sets, lines are represented as [x0, y0, n0.x, n0.y] (point on line and normalized normal direction).
+// Compared to a plain RANSAC loop it
+//  - keeps the points as contiguous x and y arrays and counts inliers in a branch-free loop (vectorizable by the compiler),
+//  - scores the points in blocks and abandons a hypothesis as soon as it cannot beat the best hypothesis anymore,
+//  - adapts the number of iterations to the inlier ratio of the best hypothesis found so far
+//    (the given inlier_ratio only defines the maximum number of iterations).
+// The object keeps its buffers between calls, so it should be reused for consecutive scans.
+// Samples are drawn from a random generator owned by the object, i.e. results are reproducible for a fixed seed.
+class LineRansac
+{
+public:
+
+	LineRansac();
+
+	// success_probability = probability for drawing two inliers at once
+	// inlier_ratio = the (minimum expected) ratio of line inliers in the point set
+	// returns false if no line could be fit
+	bool fitLine(const std::vector<cv::Point2d>& points, cv::Vec4d& line, const double inlier_ratio, const double success_probability,
+			const double max_inlier_distance, const bool draw_from_both_halves_of_point_set=false);
+
+	// scores initial_line against the points and refines it by least squares if it has at least min_inliers inliers, this costs O(points),
+	// returns false if the line does not have enough support anymore (e.g. for tracking a line over consecutive scans with fitLine as fallback)
+	bool refitLine(const std::vector<cv::Point2d>& points, const cv::Vec4d& initial_line, const double max_inlier_distance, const int min_inliers, cv::Vec4d& line);
+
+	// resets the random generator, objects with the same seed and different streams draw independent samples
+	void setSeed(const uint64_t seed, const uint64_t stream=0) { random_generator_.setSeed(seed, stream); }
+
+	// number of hypotheses tested in the last call of fitLine
+	int getIterations() const { return iterations_; }
+
+	// number of points used for the least squares fit of the last estimated line
+	int getInliers() const { return inliers_; }
+
+	// uncertainty of the last estimated line derived from the residuals of its inliers:
+	// variance of the line position along its normal at the line point [x0, y0] (the centroid of the inliers), in [m^2],
+	// and variance of the line direction, in [rad^2]
+	double getOffsetVariance() const { return offset_variance_; }
+	double getAngleVariance() const { return angle_variance_; }
+
+
+protected:
+
+	void setPoints(const std::vector<cv::Point2d>& points);
+
+	// returns the number of points within max_inlier_distance of the line n0.x*x + n0.y*y + c = 0,
+	// or -1 if the hypothesis has been abandoned because it cannot reach min_inliers
+	int countInliers(const double n0x, const double n0y, const double c, const double max_inlier_distance, const int min_inliers) const;
+
+	// least squares fit of the line to all inliers of the line n0.x*x + n0.y*y + c = 0, returns false if there are less than 2 inliers
+	bool refineLine(const double n0x, const double n0y, const double c, const double max_inlier_distance, cv::Vec4d& line);
+
+	std::vector<double> x_;
+	std::vector<double> y_;
+	int iterations_;
+	int inliers_;
+	double offset_variance_;
+	double angle_variance_;
+	RandomGenerator random_generator_;
+};
+
+
+#endif	// LINE_RANSAC_H
@@ -0,0 +1,109 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef POLYGON_MASK_H
+#define POLYGON_MASK_H
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+
+// Accelerates point in polygon tests for polygons that are fixed in the base frame.
+// The polygon is rasterized once into a grid, each cell is marked as completely inside, completely outside or touching the polygon border.
+// A lookup is O(1) for cells inside or outside, only points in border cells are tested exactly against the polygon.
+// The result is identical to cv::pointPolygonTest(polygon, point, false) >= 0.
+class PolygonMask
+{
+public:
+
+	PolygonMask();
+
+	// rasterizes the polygon, cell_size = edge length of the grid cells, in [m]
+	void setPolygon(const std::vector<cv::Point2f>& polygon, const double cell_size=0.02);
+
+	const std::vector<cv::Point2f>& getPolygon() const { return polygon_; }
+
+	// returns true if the point lies inside the polygon or on its border
+	bool contains(const double x, const double y) const
+	{
+		const double u = (x-min_x_)*inverse_cell_size_;
+		const double v = (y-min_y_)*inverse_cell_size_;
+		if (!(u >= 0. && v >= 0. && u < cols_ && v < rows_))	// also catches NaN coordinates
+			return false;
+		const unsigned char state = grid_[(int)v*cols_ + (int)u];
+		if (state == CELL_BORDER)
+			return cv::pointPolygonTest(polygon_, cv::Point2f(x, y), false) >= 0.;
+		return state == CELL_INSIDE;
+	}
+
+
+protected:
+
+	enum CellState {CELL_OUTSIDE=0, CELL_INSIDE=1, CELL_BORDER=2};
+
+	std::vector<cv::Point2f> polygon_;
+	std::vector<unsigned char> grid_;	// row-major, one CellState per cell
+	double min_x_;		// lower left corner of the grid in the base frame, in [m]
+	double min_y_;
+	double inverse_cell_size_;
+	int cols_;
+	int rows_;
+};
+
+
+#endif	// POLYGON_MASK_H
@@ -0,0 +1,116 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef RANDOM_GENERATOR_H
+#define RANDOM_GENERATOR_H
+
+#include <stdint.h>
+
+
+// Small PCG32 random number generator (O'Neill, "PCG: A Family of Simple Fast Space-Efficient Statistically Good Algorithms for Random Number Generation").
+// Each object has its own state, so estimators do not share the global state of rand() and produce reproducible results for a fixed seed.
+// Generators with the same seed but different stream numbers produce independent sequences, e.g. for parallel workers.
+class RandomGenerator
+{
+public:
+
+	RandomGenerator(const uint64_t seed=0x853c49e6748fea9bULL, const uint64_t stream=0)
+	{
+		setSeed(seed, stream);
+	}
+
+	void setSeed(const uint64_t seed, const uint64_t stream=0)
+	{
+		state_ = 0;
+		increment_ = (stream << 1u) | 1u;	// must be odd
+		next();
+		state_ += seed;
+		next();
+	}
+
+	// uniformly distributed 32 bit number
+	uint32_t next()
+	{
+		const uint64_t old_state = state_;
+		state_ = old_state*6364136223846793005ULL + increment_;
+		const uint32_t xorshifted = (uint32_t)(((old_state >> 18u) ^ old_state) >> 27u);
+		const uint32_t rotation = (uint32_t)(old_state >> 59u);
+		return (xorshifted >> rotation) | (xorshifted << ((32u-rotation) & 31u));
+	}
+
+	// uniformly distributed number in [0, bound), bound has to be > 0
+	uint32_t uniform(const uint32_t bound)
+	{
+		// reject the lowest values which would bias the modulo
+		const uint32_t threshold = (0u-bound) % bound;
+		while (true)
+		{
+			const uint32_t r = next();
+			if (r >= threshold)
+				return r % bound;
+		}
+	}
+
+
+protected:
+
+	uint64_t state_;
+	uint64_t increment_;
+};
+
+
+#endif	// RANDOM_GENERATOR_H
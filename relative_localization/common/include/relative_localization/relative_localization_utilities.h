@@ -70,10 +70,15 @@ namespace RelativeLocalizationUtilities
 
 // success_propability = probability for drawing two inliers at once
 // inlier_ratio = the ratio of line inliers in the point set
+// convenience wrapper around LineRansac, use a LineRansac object directly for repeated fits
 bool fitLine(const std::vector<cv::Point2d>& points, cv::Vec4d& line, const double inlier_ratio, const double success_probability, const double max_inlier_distance, bool draw_from_both_halves_of_point_set);
 
 double distanceToLine(const double npx, const double npy, const double n0x, const double n0y, const double pointx, const double pointy);
 
+// removes all points within max_inlier_distance of the line [x0, y0, n0.x, n0.y] by compacting the vector in place (linear time),
+// the order of the remaining points is kept
+void removeLineInliers(std::vector<cv::Point2d>& points, const cv::Vec4d& line, const double max_inlier_distance);
+
 cv::Mat makeTransform(const cv::Mat& R, const cv::Mat& t);
 
 // computes the transform from target_frame to source_frame (i.e. transform arrow is pointing from target_frame to source_frame)
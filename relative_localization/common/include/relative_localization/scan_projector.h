@@ -0,0 +1,109 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef SCAN_PROJECTOR_H
+#define SCAN_PROJECTOR_H
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+
+// Converts laser scans from polar coordinates into x-y points in the base frame.
+// The sin/cos tables of the beam angles are cached and only recomputed when angle_min, angle_increment or the number of beams change,
+// the laser to base transform is reduced to a 2d affine transform (assumes a laser scanner mounted parallel to the ground plane).
+// The points are stored as separate x and y arrays (structure of arrays) which are reused between scans, beams with NaN or inf
+// ranges are skipped, the beam index of each point is kept.
+class ScanProjector
+{
+public:
+
+	ScanProjector();
+
+	// T = 4x4 transform from laser scanner to base frame
+	void project(const std::vector<float>& ranges, const double angle_min, const double angle_increment, const cv::Mat& T);
+
+	// number of valid points of the last projected scan
+	size_t size() const { return number_points_; }
+
+	double x(const size_t i) const { return x_[i]; }
+	double y(const size_t i) const { return y_[i]; }
+	cv::Point2d point(const size_t i) const { return cv::Point2d(x_[i], y_[i]); }
+
+	// index of the beam that measured point i
+	int beamIndex(const size_t i) const { return beam_index_[i]; }
+
+
+protected:
+
+	void updateTrigonometricTables(const size_t number_beams, const double angle_min, const double angle_increment);
+
+	// cached beam directions
+	std::vector<double> cos_table_;
+	std::vector<double> sin_table_;
+	double table_angle_min_;
+	double table_angle_increment_;
+
+	// projected points of the last scan, only the first number_points_ entries are valid
+	std::vector<double> x_;
+	std::vector<double> y_;
+	std::vector<int> beam_index_;
+	size_t number_points_;
+};
+
+
+#endif	// SCAN_PROJECTOR_H
@@ -0,0 +1,121 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef SE2_POSE_FILTER_H
+#define SE2_POSE_FILTER_H
+
+#include <opencv2/opencv.hpp>
+
+
+// Kalman filter for a 2d pose (x, y, theta), e.g. the pose of a reference frame in the robot's base frame.
+// Between measurements the pose follows a random walk whose covariance grows linearly with the elapsed time,
+// measurements are full pose observations with their own covariance (e.g. derived from the residuals of the RANSAC line fits).
+// The orientation is handled on the circle, i.e. innovations are wrapped to [-pi, pi].
+// Measurements with a squared Mahalanobis distance beyond the outlier gate are rejected, after max_rejections consecutive rejections
+// the filter is re-initialized with the latest measurement (e.g. if the landmark was really moved).
+class Se2PoseFilter
+{
+public:
+
+	Se2PoseFilter();
+
+	// translation_noise in [m/sqrt(s)], rotation_noise in [rad/sqrt(s)]: standard deviation of the pose change after one second
+	void setProcessNoise(const double translation_noise, const double rotation_noise);
+
+	// gate = maximum squared Mahalanobis distance of an accepted measurement (e.g. 16.27 = 99.9% quantile of the chi-square distribution with 3 dof)
+	void setOutlierGate(const double gate, const int max_rejections);
+
+	void reset();
+
+	bool isInitialized() const { return initialized_; }
+
+	// propagates the pose covariance to time (in [s])
+	void predict(const double time);
+
+	// additionally moves the pose by a motion of the observing frame (e.g. the robot base motion measured by the odometry),
+	// motion = pose (x, y, theta) of the observing frame at the last update in the observing frame at time, motion_covariance = its uncertainty
+	void predict(const double time, const cv::Vec3d& motion, const cv::Matx33d& motion_covariance);
+
+	// fuses the pose measurement (x, y, theta) taken at time (in [s]), returns false if the measurement was rejected as outlier
+	bool update(const double time, const cv::Vec3d& measurement, const cv::Matx33d& measurement_covariance);
+
+	// pose (x, y, theta) and its covariance
+	const cv::Vec3d& getState() const { return state_; }
+	const cv::Matx33d& getCovariance() const { return covariance_; }
+
+	// maps an angle to [-pi, pi]
+	static double normalizeAngle(const double angle);
+
+
+protected:
+
+	void initialize(const double time, const cv::Vec3d& measurement, const cv::Matx33d& measurement_covariance);
+
+	bool initialized_;
+	double time_;			// time of the current state, in [s]
+	cv::Vec3d state_;
+	cv::Matx33d covariance_;
+
+	double translation_noise_;	// [m/sqrt(s)]
+	double rotation_noise_;		// [rad/sqrt(s)]
+	double outlier_gate_;
+	int max_rejections_;
+	int rejections_;			// number of consecutively rejected measurements
+};
+
+
+#endif	// SE2_POSE_FILTER_H
@@ -0,0 +1,301 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <relative_localization/corner_ransac.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+//#define DEBUG_OUTPUT
+
+
+// number of points scored before checking whether a hypothesis can still beat the best one
+static const int SCORING_BLOCK_SIZE = 64;
+
+// returns the number of points within max_inlier_distance of the line n0.x*x + n0.y*y + c = 0,
+// or -1 as soon as the inliers cannot reach min_inliers anymore, even if all remaining points and additional_points were inliers
+static int countLineInliers(const double* x, const double* y, const int size, const double n0x, const double n0y, const double c,
+		const double max_inlier_distance, const int min_inliers, const int additional_points)
+{
+	int inliers = 0;
+	for (int start=0; start<size; start+=SCORING_BLOCK_SIZE)
+	{
+		const int end = std::min(start+SCORING_BLOCK_SIZE, size);
+		int block_inliers = 0;
+		for (int i=start; i<end; ++i)
+			block_inliers += (fabs(n0x*x[i] + n0y*y[i] + c) <= max_inlier_distance);
+		inliers += block_inliers;
+		if (inliers + (size-end) + additional_points < min_inliers)
+			return -1;
+	}
+	return inliers;
+}
+
+// counts the side wall inliers like countLineInliers, points within min_front_distance of the front wall line n0*p = a are not
+// assigned to the side wall (they belong to the front wall or are too close to the corner to tell)
+static int countSideInliers(const double* x, const double* y, const int size, const double n0x, const double n0y, const double a, const double b,
+		const double max_inlier_distance, const double min_front_distance, const int min_inliers)
+{
+	int inliers = 0;
+	for (int start=0; start<size; start+=SCORING_BLOCK_SIZE)
+	{
+		const int end = std::min(start+SCORING_BLOCK_SIZE, size);
+		int block_inliers = 0;
+		for (int i=start; i<end; ++i)
+			block_inliers += (fabs(-n0y*x[i] + n0x*y[i] - b) <= max_inlier_distance && fabs(n0x*x[i] + n0y*y[i] - a) > min_front_distance);
+		inliers += block_inliers;
+		if (inliers + (size-end) < min_inliers)
+			return -1;
+	}
+	return inliers;
+}
+
+static void copyPoints(const std::vector<cv::Point2d>& points, std::vector<double>& x, std::vector<double>& y)
+{
+	x.resize(points.size());
+	y.resize(points.size());
+	for (size_t i=0; i<points.size(); ++i)
+	{
+		x[i] = points[i].x;
+		y[i] = points[i].y;
+	}
+}
+
+
+CornerRansac::CornerRansac()
+	: iterations_(0), front_inliers_(0), side_inliers_(0), front_offset_variance_(0.), side_offset_variance_(0.), angle_variance_(0.)
+{
+}
+
+bool CornerRansac::fitCorner(const std::vector<cv::Point2d>& front_points, const std::vector<cv::Point2d>& side_points, cv::Vec4d& line_front, cv::Vec4d& line_side,
+		const double inlier_ratio, const double success_probability, const double max_inlier_distance, const double min_front_normal_x)
+{
+	iterations_ = 0;
+	front_inliers_ = 0;
+	side_inliers_ = 0;
+	const int front_samples = (int)front_points.size();
+	const int side_samples = (int)side_points.size();
+	if (front_samples < 2 || side_samples < 2)
+	{
+		std::cout << "CornerRansac::fitCorner - Warning: Not enough points to fit a corner!" << std::endl;
+		return false;
+	}
+	copyPoints(front_points, front_x_, front_y_);
+	copyPoints(side_points, side_x_, side_y_);
+	const double* fx = &front_x_[0];
+	const double* fy = &front_y_[0];
+	const double* sx = &side_x_[0];
+	const double* sy = &side_y_[0];
+	const double min_front_distance = 2.*max_inlier_distance;
+
+	// RANSAC iterations, a minimal sample needs two front wall inliers and one side wall inlier
+	const double log_failure_probability = log(1.-success_probability);
+	int iterations = (int)(log_failure_probability/log(1.-inlier_ratio*inlier_ratio*inlier_ratio));
+	int max_inliers = 0;
+	cv::Point2d best_n0;
+	double best_a = 0., best_b = 0.;
+	for (int k=0; k<iterations; ++k)
+	{
+		++iterations_;
+
+		// front wall line from two different front points
+		const int index1 = random_generator_.uniform(front_samples);
+		int index2 = index1;
+		while (index2==index1)
+			index2 = random_generator_.uniform(front_samples);
+		double n0x = fy[index2]-fy[index1];
+		double n0y = fx[index1]-fx[index2];
+		const double n0_length = sqrt(n0x*n0x + n0y*n0y);
+		if (n0_length < 1e-12)		// identical points
+			continue;
+		n0x /= n0_length; n0y /= n0_length;
+		if (fabs(n0x) < min_front_normal_x)		// front wall has to face the robot
+			continue;
+		const double a = n0x*fx[index1] + n0y*fy[index1];		// front line: n0*p = a
+
+		// perpendicular side wall line through one side point, with normal t = [-n0.y, n0.x]
+		const int index3 = random_generator_.uniform(side_samples);
+		if (fabs(n0x*sx[index3] + n0y*sy[index3] - a) <= min_front_distance)		// point of the front wall
+			continue;
+		const double b = -n0y*sx[index3] + n0x*sy[index3];		// side line: t*p = b
+
+		// count inliers of both walls, stop early if the best model cannot be beaten anymore
+		const int front_inliers = countLineInliers(fx, fy, front_samples, n0x, n0y, -a, max_inlier_distance, max_inliers+1, side_samples);
+		if (front_inliers < 0)
+			continue;
+		const int side_inliers = countSideInliers(sx, sy, side_samples, n0x, n0y, a, b, max_inlier_distance, min_front_distance, max_inliers+1-front_inliers);
+		if (side_inliers < 0)
+			continue;
+
+		// update best model
+		if (front_inliers+side_inliers > max_inliers)
+		{
+			max_inliers = front_inliers+side_inliers;
+			best_n0 = cv::Point2d(n0x, n0y);
+			best_a = a;
+			best_b = b;
+
+			// adapt the number of iterations to the inlier ratios of the best model
+			const double front_ratio = (double)front_inliers/(double)front_samples;
+			const double side_ratio = (double)side_inliers/(double)side_samples;
+			const double adapted_iterations = ceil(log_failure_probability/log(std::max(1e-12, 1.-front_ratio*front_ratio*side_ratio)));
+			if (adapted_iterations < iterations)
+				iterations = (int)adapted_iterations;
+		}
+	}
+
+	if (max_inliers == 0)
+	{
+		std::cout << "CornerRansac::fitCorner - Warning: No valid corner hypothesis found!" << std::endl;
+		return false;
+	}
+
+#ifdef DEBUG_OUTPUT
+	std::cout << "CornerRansac::fitCorner: iterations: " << iterations_ << "  inliers: " << max_inliers << "/" << front_samples+side_samples << std::endl;
+#endif
+
+	// joint least squares refinement, the inlier sets are updated once with the refined model
+	for (int i=0; i<2; ++i)
+		if (refineCorner(best_n0, best_a, best_b, max_inlier_distance, line_front, line_side) == false)
+			return false;
+
+	return fabs(best_n0.x) >= min_front_normal_x;
+}
+
+bool CornerRansac::isSideInlier(const double x, const double y, const cv::Point2d& n0, const double a, const double b, const double max_inlier_distance) const
+{
+	return fabs(-n0.y*x + n0.x*y - b) <= max_inlier_distance && fabs(n0.x*x + n0.y*y - a) > 2.*max_inlier_distance;
+}
+
+bool CornerRansac::refineCorner(cv::Point2d& n0, double& a, double& b, const double max_inlier_distance, cv::Vec4d& line_front, cv::Vec4d& line_side)
+{
+	// centroids of the inliers of both walls
+	int front_inliers = 0, side_inliers = 0;
+	double fmx = 0., fmy = 0., smx = 0., smy = 0.;
+	for (size_t i=0; i<front_x_.size(); ++i)
+	{
+		if (fabs(n0.x*front_x_[i] + n0.y*front_y_[i] - a) <= max_inlier_distance)
+		{
+			fmx += front_x_[i];
+			fmy += front_y_[i];
+			++front_inliers;
+		}
+	}
+	for (size_t i=0; i<side_x_.size(); ++i)
+	{
+		if (isSideInlier(side_x_[i], side_y_[i], n0, a, b, max_inlier_distance))
+		{
+			smx += side_x_[i];
+			smy += side_y_[i];
+			++side_inliers;
+		}
+	}
+	if (front_inliers < 2 || side_inliers < 1)
+		return false;
+	fmx /= front_inliers; fmy /= front_inliers;
+	smx /= side_inliers; smy /= side_inliers;
+
+	// scatter matrices of both walls
+	double fxx = 0., fxy = 0., fyy = 0., sxx = 0., sxy = 0., syy = 0.;
+	for (size_t i=0; i<front_x_.size(); ++i)
+	{
+		if (fabs(n0.x*front_x_[i] + n0.y*front_y_[i] - a) <= max_inlier_distance)
+		{
+			const double dx = front_x_[i]-fmx;
+			const double dy = front_y_[i]-fmy;
+			fxx += dx*dx; fxy += dx*dy; fyy += dy*dy;
+		}
+	}
+	for (size_t i=0; i<side_x_.size(); ++i)
+	{
+		if (isSideInlier(side_x_[i], side_y_[i], n0, a, b, max_inlier_distance))
+		{
+			const double dx = side_x_[i]-smx;
+			const double dy = side_y_[i]-smy;
+			sxx += dx*dx; sxy += dx*dy; syy += dy*dy;
+		}
+	}
+
+	// the sum of squared residuals of both walls is n0^T*M*n0 with M = S_front + R90^T*S_side*R90 (the side wall residuals are measured along t = R90*n0),
+	// the optimal front normal is the eigenvector of the smallest eigenvalue of M
+	const double mxx = fxx + syy;
+	const double mxy = fxy - sxy;
+	const double myy = fyy + sxx;
+	const double angle = 0.5*atan2(2.*mxy, mxx-myy);		// direction of the largest eigenvalue
+	cv::Point2d n(-sin(angle), cos(angle));
+	if (n.x*n0.x + n.y*n0.y < 0.)
+		n *= -1.;
+	n0 = n;
+	const cv::Point2d t(-n0.y, n0.x);
+	a = n0.x*fmx + n0.y*fmy;
+	b = t.x*smx + t.y*smy;
+	line_front = cv::Vec4d(fmx, fmy, n0.x, n0.y);
+	line_side = cv::Vec4d(smx, smy, t.x, t.y);
+	front_inliers_ = front_inliers;
+	side_inliers_ = side_inliers;
+
+	// uncertainty from the residuals, the common direction is constrained by the extent of both walls
+	const double residual_sum = std::max(0., n0.x*n0.x*mxx + 2.*n0.x*n0.y*mxy + n0.y*n0.y*myy);
+	const double extent_sum = std::max(1e-12, t.x*t.x*fxx + 2.*t.x*t.y*fxy + t.y*t.y*fyy + n0.x*n0.x*sxx + 2.*n0.x*n0.y*sxy + n0.y*n0.y*syy);
+	const int degrees_of_freedom = front_inliers + side_inliers - 3;
+	const double noise_variance = (degrees_of_freedom > 0 ? std::max(1e-8, residual_sum/degrees_of_freedom) : max_inlier_distance*max_inlier_distance/3.);
+	front_offset_variance_ = noise_variance/front_inliers;
+	side_offset_variance_ = noise_variance/side_inliers;
+	angle_variance_ = noise_variance/extent_sum;
+	return true;
+}
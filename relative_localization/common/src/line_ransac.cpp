@@ -0,0 +1,257 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <relative_localization/line_ransac.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+//#define DEBUG_OUTPUT
+
+
+// number of points scored before checking whether a hypothesis can still beat the best one
+static const int SCORING_BLOCK_SIZE = 64;
+
+
+LineRansac::LineRansac()
+	: iterations_(0), inliers_(0), offset_variance_(0.), angle_variance_(0.)
+{
+}
+
+bool LineRansac::fitLine(const std::vector<cv::Point2d>& points, cv::Vec4d& line, const double inlier_ratio, const double success_probability,
+		const double max_inlier_distance, const bool draw_from_both_halves_of_point_set)
+{
+	iterations_ = 0;
+	inliers_ = 0;
+	const int samples = (int)points.size();
+	if (samples < 2)
+	{
+		std::cout << "LineRansac::fitLine - Warning: Not enough points to fit a line!" << std::endl;
+		return false;
+	}
+	setPoints(points);
+
+	// RANSAC iterations, the iteration count is reduced as soon as a hypothesis with a higher inlier ratio is found
+	const double log_failure_probability = log(1.-success_probability);
+	int iterations = (int)(log_failure_probability/log(1.-inlier_ratio*inlier_ratio));
+	int max_inliers = 0;
+	cv::Vec4d best_line;
+	for (int k=0; k<iterations; ++k)
+	{
+		++iterations_;
+
+		// draw two different points from samples
+		int index1, index2;
+		if (draw_from_both_halves_of_point_set == false)
+		{
+			index1 = random_generator_.uniform(samples);
+			index2 = index1;
+			while (index2==index1)
+				index2 = random_generator_.uniform(samples);
+		}
+		else
+		{
+			index1 = random_generator_.uniform(samples/2);
+			index2 = std::min((samples/2)+(int)random_generator_.uniform(samples/2), samples-1);
+		}
+
+		// compute line equation from points: d = n0 * (x - x0)  (x0=point on line, n0=normalized normal on line, d=distance to line, d=0 -> line)
+		double n0x = y_[index2]-y_[index1];
+		double n0y = x_[index1]-x_[index2];
+		const double n0_length = sqrt(n0x*n0x + n0y*n0y);
+		if (n0_length < 1e-12)		// identical points
+			continue;
+		n0x /= n0_length; n0y /= n0_length;
+		const double c = -x_[index1]*n0x - y_[index1]*n0y;		// distance to line: d = n0*(x-x0) = n0.x*x + n0.y*y + c
+
+		// count inliers, stop early if the best model cannot be beaten anymore
+		const int inliers = countInliers(n0x, n0y, c, max_inlier_distance, max_inliers+1);
+
+		// update best model
+		if (inliers > max_inliers)
+		{
+			max_inliers = inliers;
+			best_line = cv::Vec4d(x_[index1], y_[index1], n0x, n0y);		// [x0, y0, n0.x, n0.y]
+
+			// adapt the number of iterations to the inlier ratio of the best model
+			const double ratio = (double)max_inliers/(double)samples;
+			const double adapted_iterations = ceil(log_failure_probability/log(std::max(1e-12, 1.-ratio*ratio)));
+			if (adapted_iterations < iterations)
+				iterations = (int)adapted_iterations;
+		}
+	}
+
+	if (max_inliers == 0)
+	{
+		std::cout << "LineRansac::fitLine - Warning: No valid line hypothesis found!" << std::endl;
+		return false;
+	}
+
+#ifdef DEBUG_OUTPUT
+	std::cout << "LineRansac::fitLine: iterations: " << iterations_ << "  inliers: " << max_inliers << "/" << samples << std::endl;
+	std::cout << "Ransac line: " << best_line << std::endl;
+#endif
+
+	// final optimization with least squares fit
+	const double c = -best_line[0]*best_line[2] - best_line[1]*best_line[3];
+	if (refineLine(best_line[2], best_line[3], c, max_inlier_distance, line) == false)
+		return false;
+
+#ifdef DEBUG_OUTPUT
+	std::cout << "Optimized line: " << line << std::endl;
+#endif
+
+	return true;
+}
+
+bool LineRansac::refitLine(const std::vector<cv::Point2d>& points, const cv::Vec4d& initial_line, const double max_inlier_distance, const int min_inliers, cv::Vec4d& line)
+{
+	iterations_ = 0;
+	inliers_ = 0;
+	if ((int)points.size() < std::max(2, min_inliers))
+		return false;
+	setPoints(points);
+
+	const double c = -initial_line[0]*initial_line[2] - initial_line[1]*initial_line[3];
+	if (countInliers(initial_line[2], initial_line[3], c, max_inlier_distance, std::max(2, min_inliers)) < 0)
+		return false;
+	return refineLine(initial_line[2], initial_line[3], c, max_inlier_distance, line);
+}
+
+void LineRansac::setPoints(const std::vector<cv::Point2d>& points)
+{
+	x_.resize(points.size());
+	y_.resize(points.size());
+	for (size_t i=0; i<points.size(); ++i)
+	{
+		x_[i] = points[i].x;
+		y_[i] = points[i].y;
+	}
+}
+
+int LineRansac::countInliers(const double n0x, const double n0y, const double c, const double max_inlier_distance, const int min_inliers) const
+{
+	const int samples = (int)x_.size();
+	const double* x = &x_[0];
+	const double* y = &y_[0];
+	int inliers = 0;
+	for (int start=0; start<samples; start+=SCORING_BLOCK_SIZE)
+	{
+		const int end = std::min(start+SCORING_BLOCK_SIZE, samples);
+		int block_inliers = 0;
+		for (int i=start; i<end; ++i)
+			block_inliers += (fabs(n0x*x[i] + n0y*y[i] + c) <= max_inlier_distance);	// count points that are within a margin around the line
+		inliers += block_inliers;
+
+		// abandon the hypothesis if even all remaining points cannot make it reach min_inliers
+		if (inliers + (samples-end) < min_inliers)
+			return -1;
+	}
+	return inliers;
+}
+
+bool LineRansac::refineLine(const double n0x, const double n0y, const double c, const double max_inlier_distance, cv::Vec4d& line)
+{
+	// centroid and covariance of the inliers
+	const int samples = (int)x_.size();
+	int inliers = 0;
+	double sx = 0., sy = 0.;
+	for (int i=0; i<samples; ++i)
+	{
+		if (fabs(n0x*x_[i] + n0y*y_[i] + c) <= max_inlier_distance)
+		{
+			sx += x_[i];
+			sy += y_[i];
+			++inliers;
+		}
+	}
+	if (inliers < 2)
+		return false;
+	const double mx = sx/inliers;
+	const double my = sy/inliers;
+	double sxx = 0., sxy = 0., syy = 0.;
+	for (int i=0; i<samples; ++i)
+	{
+		if (fabs(n0x*x_[i] + n0y*y_[i] + c) <= max_inlier_distance)
+		{
+			const double dx = x_[i]-mx;
+			const double dy = y_[i]-my;
+			sxx += dx*dx;
+			sxy += dx*dy;
+			syy += dy*dy;
+		}
+	}
+
+	// the line direction is the principal axis of the inliers (total least squares, equivalent to cv::fitLine with CV_DIST_L2)
+	const double angle = 0.5*atan2(2.*sxy, sxx-syy);
+	const double vx = cos(angle);
+	const double vy = sin(angle);
+	line = cv::Vec4d(mx, my, vy, -vx);	// store optimized line and its normal vector
+	inliers_ = inliers;
+
+	// the eigenvalues of the scatter matrix are the sums of squared distances across (residuals) and along the line
+	const double half_trace = 0.5*(sxx+syy);
+	const double half_difference = sqrt(0.25*(sxx-syy)*(sxx-syy) + sxy*sxy);
+	const double residual_sum = std::max(0., half_trace-half_difference);
+	const double extent_sum = std::max(1e-12, half_trace+half_difference);
+	// noise variance of the points, with only two points use the variance of a uniform distribution within the inlier margin
+	const double noise_variance = (inliers > 2 ? std::max(1e-8, residual_sum/(inliers-2)) : max_inlier_distance*max_inlier_distance/3.);
+	offset_variance_ = noise_variance/inliers;
+	angle_variance_ = noise_variance/extent_sum;
+	return true;
+}
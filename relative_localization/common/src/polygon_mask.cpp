@@ -0,0 +1,119 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <relative_localization/polygon_mask.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+PolygonMask::PolygonMask()
+	: min_x_(0.), min_y_(0.), inverse_cell_size_(0.), cols_(0), rows_(0)
+{
+}
+
+void PolygonMask::setPolygon(const std::vector<cv::Point2f>& polygon, const double cell_size)
+{
+	polygon_ = polygon;
+	grid_.clear();
+	cols_ = 0;
+	rows_ = 0;
+	if (polygon_.size() < 3 || cell_size <= 0.)
+		return;
+
+	// bounding box of the polygon, extended by one cell on each side so that the polygon border never touches the grid border
+	double max_x = polygon_[0].x, max_y = polygon_[0].y;
+	min_x_ = polygon_[0].x;
+	min_y_ = polygon_[0].y;
+	for (size_t i=1; i<polygon_.size(); ++i)
+	{
+		min_x_ = std::min(min_x_, (double)polygon_[i].x);
+		min_y_ = std::min(min_y_, (double)polygon_[i].y);
+		max_x = std::max(max_x, (double)polygon_[i].x);
+		max_y = std::max(max_y, (double)polygon_[i].y);
+	}
+
+	// limit the grid size for very large polygons
+	double size = cell_size;
+	const double max_cells = 1<<20;
+	while (((max_x-min_x_)/size + 2.) * ((max_y-min_y_)/size + 2.) > max_cells)
+		size *= 2.;
+	min_x_ -= size;
+	min_y_ -= size;
+	cols_ = (int)ceil((max_x-min_x_)/size) + 1;
+	rows_ = (int)ceil((max_y-min_y_)/size) + 1;
+	inverse_cell_size_ = 1./size;
+
+	// classify each cell by the signed distance of its center to the polygon border,
+	// cells closer to the border than half of the cell diagonal (plus a margin for float precision) need an exact test
+	const double border_distance = 0.5*sqrt(2.)*size*1.01 + 1e-6;
+	grid_.resize(cols_*rows_);
+	for (int v=0; v<rows_; ++v)
+	{
+		for (int u=0; u<cols_; ++u)
+		{
+			const cv::Point2f center(min_x_ + (u+0.5)*size, min_y_ + (v+0.5)*size);
+			const double distance = cv::pointPolygonTest(polygon_, center, true);	// positive inside the polygon
+			if (distance > border_distance)
+				grid_[v*cols_ + u] = CELL_INSIDE;
+			else if (distance < -border_distance)
+				grid_[v*cols_ + u] = CELL_OUTSIDE;
+			else
+				grid_[v*cols_ + u] = CELL_BORDER;
+		}
+	}
+}
@@ -56,86 +56,14 @@
  ****************************************************************/
 
 #include <relative_localization/relative_localization_utilities.h>
-
-//#define DEBUG_OUTPUT
+#include <relative_localization/line_ransac.h>
 
 namespace RelativeLocalizationUtilities
 {
 	bool fitLine(const std::vector<cv::Point2d>& points, cv::Vec4d& line, const double inlier_ratio, const double success_probability, const double max_inlier_distance, bool draw_from_both_halves_of_point_set)
 	{
-		const int iterations = (int)(log(1.-success_probability)/log(1.-inlier_ratio*inlier_ratio));
-	#ifdef DEBUG_OUTPUT
-		std::cout << "fitLine: iterations: " << iterations << std::endl;
-	#endif
-		const int samples = (int)points.size();
-
-		if ( samples < 2 )
-		{
-			std::cout << "fitLine - Warning: Not enough points to fit a line!" << std::endl;
-			return false;
-		}
-
-		// RANSAC iterations
-		int max_inliers = 0;
-		for (int k=0; k<iterations; ++k)
-		{
-			// draw two different points from samples
-			int index1, index2;
-			if (draw_from_both_halves_of_point_set == false)
-			{
-				index1 = rand()%samples;
-				index2 = index1;
-				while (index2==index1)
-					index2 = rand()%samples;
-			}
-			else
-			{
-				index1 = rand()%(samples/2);
-				index2 = std::min((samples/2)+rand()%(samples/2), samples-1);
-			}
-
-			// compute line equation from points: d = n0 * (x - x0)  (x0=point on line, n0=normalized normal on line, d=distance to line, d=0 -> line)
-			cv::Point2d x0 = points[index1];	// point on line
-			cv::Point2d n0(points[index2].y-points[index1].y, points[index1].x-points[index2].x);	// normal direction on line
-			const double n0_length = sqrt(n0.x*n0.x + n0.y*n0.y);
-			n0.x /= n0_length; n0.y /= n0_length;
-			const double c = -points[index1].x*n0.x - points[index1].y*n0.y;		// distance to line: d = n0*(x-x0) = n0.x*x + n0.y*y + c
-
-			// count inliers
-			int inliers = 0;
-			for (size_t i=0; i<points.size(); ++i)
-				if (fabs(n0.x * points[i].x + n0.y * points[i].y + c) <= max_inlier_distance) // count points that are within a margin around the line
-					++inliers;
-
-			// update best model
-			if (inliers > max_inliers)
-			{
-				max_inliers = inliers;
-				line = cv::Vec4d(points[index1].x, points[index1].y, n0.x, n0.y);		// [x0, y0, n0.x, n0.y]
-			}
-		}
-
-	#ifdef DEBUG_OUTPUT
-		std::cout << "Ransac line: " << line << std::endl;
-	#endif
-
-		// final optimization with least squares fit
-		const cv::Point2d n0(line[2], line[3]);
-		const double c = -line[0]*n0.x - line[1]*n0.y;
-		std::vector<cv::Point2f> inlier_set;
-		for (size_t i=0; i<points.size(); ++i)
-			if (fabs(n0.x * points[i].x + n0.y * points[i].y + c) <= max_inlier_distance)
-				inlier_set.push_back(cv::Point2f(points[i].x, points[i].y));
-		cv::Vec4f line_ls;
-		cv::fitLine(inlier_set, line_ls, CV_DIST_L2, 0, 0.01, 0.01);	// (vx, vy, x0, y0), where (vx, vy) is a normalized vector collinear to the line and (x0, y0) is a point on the line
-		const double length = sqrt(line_ls[0]*line_ls[0]+line_ls[1]*line_ls[1]);
-		line = cv::Vec4d(line_ls[2], line_ls[3], line_ls[1]/length, -line_ls[0]/length); // store optimized line and its normal vector
-
-	#ifdef DEBUG_OUTPUT
-		std::cout << "Optimized line: " << line << std::endl;
-	#endif
-
-		return true;
+		LineRansac line_ransac;
+		return line_ransac.fitLine(points, line, inlier_ratio, success_probability, max_inlier_distance, draw_from_both_halves_of_point_set);
 	}
 
 	// (npx, npy) = a point on the line
@@ -146,6 +74,18 @@ namespace RelativeLocalizationUtilities
 		return fabs(n0x*(pointx-npx) + n0y*(pointy-npy));
 	}
 
+	void removeLineInliers(std::vector<cv::Point2d>& points, const cv::Vec4d& line, const double max_inlier_distance)
+	{
+		size_t k = 0;
+		for (size_t i=0; i<points.size(); ++i)
+		{
+			const double dist = distanceToLine(line.val[0], line.val[1], line.val[2], line.val[3], points[i].x, points[i].y);
+			if (!(dist <= max_inlier_distance))
+				points[k++] = points[i];
+		}
+		points.resize(k);
+	}
+
 	cv::Mat makeTransform(const cv::Mat& R, const cv::Mat& t)
 	{
 		cv::Mat T = (cv::Mat_<double>(4,4) <<
@@ -0,0 +1,124 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <relative_localization/scan_projector.h>
+
+#include <cfloat>
+#include <cmath>
+
+
+ScanProjector::ScanProjector()
+	: table_angle_min_(0.), table_angle_increment_(0.), number_points_(0)
+{
+}
+
+void ScanProjector::updateTrigonometricTables(const size_t number_beams, const double angle_min, const double angle_increment)
+{
+	if (cos_table_.size() == number_beams && table_angle_min_ == angle_min && table_angle_increment_ == angle_increment)
+		return;
+
+	cos_table_.resize(number_beams);
+	sin_table_.resize(number_beams);
+	for (size_t i=0; i<number_beams; ++i)
+	{
+		const double angle = angle_min + i * angle_increment; // [rad]
+		cos_table_[i] = cos(angle);
+		sin_table_[i] = sin(angle);
+	}
+	table_angle_min_ = angle_min;
+	table_angle_increment_ = angle_increment;
+}
+
+void ScanProjector::project(const std::vector<float>& ranges, const double angle_min, const double angle_increment, const cv::Mat& T)
+{
+	const size_t number_beams = ranges.size();
+	updateTrigonometricTables(number_beams, angle_min, angle_increment);
+	x_.resize(number_beams);
+	y_.resize(number_beams);
+	beam_index_.resize(number_beams);
+
+	// 2d part of the laser to base transform, z=0 for all laser points
+	const double r00 = T.at<double>(0,0), r01 = T.at<double>(0,1), tx = T.at<double>(0,3);
+	const double r10 = T.at<double>(1,0), r11 = T.at<double>(1,1), ty = T.at<double>(1,3);
+
+	// transform all beams in a branch-free loop over contiguous arrays (vectorizable by the compiler)
+	const float* range = number_beams>0 ? &ranges[0] : 0;
+	const double* c = number_beams>0 ? &cos_table_[0] : 0;
+	const double* s = number_beams>0 ? &sin_table_[0] : 0;
+	double* px = number_beams>0 ? &x_[0] : 0;
+	double* py = number_beams>0 ? &y_[0] : 0;
+	for (size_t i=0; i<number_beams; ++i)
+	{
+		const double lx = range[i]*c[i];
+		const double ly = range[i]*s[i];
+		px[i] = r00*lx + r01*ly + tx;
+		py[i] = r10*lx + r11*ly + ty;
+	}
+
+	// compact the valid points in place, NaN and inf ranges fail the comparison
+	size_t k = 0;
+	for (size_t i=0; i<number_beams; ++i)
+	{
+		if (!(fabs(range[i]) <= FLT_MAX))
+			continue;
+		px[k] = px[i];
+		py[k] = py[i];
+		beam_index_[k] = (int)i;
+		++k;
+	}
+	number_points_ = k;
+}
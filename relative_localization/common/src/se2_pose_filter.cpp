@@ -0,0 +1,171 @@
+/*!
+ *****************************************************************
+ * \file
+ *
+ * \note
+ * Copyright (c) 2026 \n
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA) \n\n
+ *
+ *****************************************************************
+ *
+* \note
+* Repository name: squirrel_calibration
+* \note
+* ROS package name: relative_localization
+ *
+ * \author
+ * Author: Richard Bormann
+ * \author
+ * Supervised by:
+ *
+ * \date Date of creation: 19.10.2026
+ *
+ * \brief
+ *
+ *
+ *****************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer. \n
+ * - Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution. \n
+ * - Neither the name of the Fraunhofer Institute for Manufacturing
+ * Engineering and Automation (IPA) nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission. \n
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <relative_localization/se2_pose_filter.h>
+
+#include <cmath>
+
+
+Se2PoseFilter::Se2PoseFilter()
+	: initialized_(false), time_(0.), translation_noise_(0.05), rotation_noise_(0.05), outlier_gate_(16.27), max_rejections_(5), rejections_(0)
+{
+}
+
+void Se2PoseFilter::setProcessNoise(const double translation_noise, const double rotation_noise)
+{
+	translation_noise_ = translation_noise;
+	rotation_noise_ = rotation_noise;
+}
+
+void Se2PoseFilter::setOutlierGate(const double gate, const int max_rejections)
+{
+	outlier_gate_ = gate;
+	max_rejections_ = max_rejections;
+}
+
+void Se2PoseFilter::reset()
+{
+	initialized_ = false;
+	rejections_ = 0;
+}
+
+double Se2PoseFilter::normalizeAngle(const double angle)
+{
+	return atan2(sin(angle), cos(angle));
+}
+
+void Se2PoseFilter::initialize(const double time, const cv::Vec3d& measurement, const cv::Matx33d& measurement_covariance)
+{
+	initialized_ = true;
+	time_ = time;
+	state_ = measurement;
+	state_[2] = normalizeAngle(state_[2]);
+	covariance_ = measurement_covariance;
+	rejections_ = 0;
+}
+
+void Se2PoseFilter::predict(const double time)
+{
+	if (initialized_ == false || time <= time_)
+		return;
+
+	// random walk of the pose
+	const double dt = time - time_;
+	covariance_(0,0) += translation_noise_*translation_noise_*dt;
+	covariance_(1,1) += translation_noise_*translation_noise_*dt;
+	covariance_(2,2) += rotation_noise_*rotation_noise_*dt;
+	time_ = time;
+}
+
+void Se2PoseFilter::predict(const double time, const cv::Vec3d& motion, const cv::Matx33d& motion_covariance)
+{
+	if (initialized_ == false)
+		return;
+	predict(time);
+
+	// pose in the moved frame: p' = R(motion_theta)*p + motion_t, theta' = theta + motion_theta
+	const double c = cos(motion[2]);
+	const double s = sin(motion[2]);
+	const double x = state_[0];
+	const double y = state_[1];
+	state_[0] = c*x - s*y + motion[0];
+	state_[1] = s*x + c*y + motion[1];
+	state_[2] = normalizeAngle(state_[2] + motion[2]);
+
+	// covariance propagation with the Jacobians with respect to the pose and to the motion
+	const cv::Matx33d jacobian_pose(c, -s, 0., s, c, 0., 0., 0., 1.);
+	const cv::Matx33d jacobian_motion(1., 0., -s*x - c*y, 0., 1., c*x - s*y, 0., 0., 1.);
+	covariance_ = jacobian_pose * covariance_ * jacobian_pose.t() + jacobian_motion * motion_covariance * jacobian_motion.t();
+}
+
+bool Se2PoseFilter::update(const double time, const cv::Vec3d& measurement, const cv::Matx33d& measurement_covariance)
+{
+	if (initialized_ == false)
+	{
+		initialize(time, measurement, measurement_covariance);
+		return true;
+	}
+
+	predict(time);
+
+	// innovation, the measurement observes the full state
+	cv::Vec3d innovation = measurement - state_;
+	innovation[2] = normalizeAngle(innovation[2]);
+	const cv::Matx33d innovation_covariance_inverse = (covariance_ + measurement_covariance).inv(cv::DECOMP_CHOLESKY);
+
+	// outlier gate
+	const double mahalanobis_distance = innovation.dot(innovation_covariance_inverse * innovation);
+	if (!(mahalanobis_distance <= outlier_gate_))
+	{
+		++rejections_;
+		if (rejections_ > max_rejections_)
+		{
+			initialize(time, measurement, measurement_covariance);
+			return true;
+		}
+		return false;
+	}
+	rejections_ = 0;
+
+	// correction
+	const cv::Matx33d gain = covariance_ * innovation_covariance_inverse;
+	state_ += gain * innovation;
+	state_[2] = normalizeAngle(state_[2]);
+	covariance_ = (cv::Matx33d::eye() - gain) * covariance_;
+	covariance_ = 0.5 * (covariance_ + covariance_.t());		// keep the covariance symmetric
+	return true;
+}
@@ -75,6 +75,7 @@ protected:
 
 	//double box_search_width_;		// the maximum +/-y coordinate in laser scan to search for the localization box, in[m]
 	std::vector<cv::Point2f> box_search_polygon_;
+	PolygonMask box_search_mask_;		// rasterized box_search_polygon_
 };
 
 #endif // BOX_LOCALIZATION_H
@@ -60,6 +60,7 @@
 
 
 #include <relative_localization/reference_localization.h>
+#include <relative_localization/corner_ransac.h>
 
 class CornerLocalization : public ReferenceLocalization
 {
@@ -73,7 +74,32 @@ protected:
 	void callback(const sensor_msgs::LaserScan::ConstPtr& laser_scan_msg);
 	void dynamicReconfigureCallback(robotino_calibration::RelativeLocalizationConfig& config, uint32_t level);
 
+	// variances of the front and side wall lines, see LineRansac
+	struct WallVariances
+	{
+		double front_offset_;
+		double front_angle_;
+		double side_offset_;
+		double side_angle_;
+	};
+
+	// estimates the front wall first and then searches a perpendicular side wall among the remaining side polygon points,
+	// scan_front is modified (inliers of rejected front wall lines are removed)
+	bool estimateWallsSequentially(std::vector<cv::Point2d>& scan_front, const std::vector<cv::Point2d>& scan_side_all, const ros::Time& time_stamp,
+			const double inlier_distance, cv::Vec4d& line_front, cv::Vec4d& line_side, WallVariances& variances);
+
+	// estimates both walls at once with the L-shaped corner model (CornerRansac) unless both wall tracks can be continued
+	bool estimateWallsJointly(const std::vector<cv::Point2d>& scan_front, const std::vector<cv::Point2d>& scan_side_all, const ros::Time& time_stamp,
+			const double inlier_distance, cv::Vec4d& line_front, cv::Vec4d& line_side, WallVariances& variances);
+
+	// copies the points of scan_side_all which are farther than min_distance from the front wall line to scan_side
+	void removeFrontWallPoints(const std::vector<cv::Point2d>& scan_side_all, const cv::Vec4d& line_front, const double min_distance, std::vector<cv::Point2d>& scan_side);
+
 	std::vector<cv::Point2f> side_wall_polygon_;	// polygon points that define the area which is used to find the side wall inside, in [m]
+	PolygonMask side_wall_mask_;		// rasterized side_wall_polygon_
+	WallTrack side_wall_track_;
+	CornerRansac corner_ransac_;		// joint estimator of front and side wall
+	bool joint_corner_fit_;		// if true, front and side wall are estimated jointly as perpendicular lines (CornerRansac), otherwise one after the other (LineRansac)
 };
 
 #endif // CORNER_LOCALIZATION_H
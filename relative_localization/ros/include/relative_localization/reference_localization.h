@@ -67,6 +67,7 @@
 // messages
 #include <sensor_msgs/LaserScan.h>
 #include <visualization_msgs/Marker.h>
+#include <geometry_msgs/PoseWithCovarianceStamped.h>
 #include <std_msgs/Bool.h>
 
 // tf
@@ -78,10 +79,20 @@
 #include <dynamic_reconfigure/server.h>
 #include <relative_localization/RelativeLocalizationConfig.h>
 
+// Boost
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
 // OpenCV
 #include <opencv2/opencv.hpp>
 //#include <opencv2/highgui/highgui.hpp>
 
+#include <relative_localization/scan_projector.h>
+#include <relative_localization/polygon_mask.h>
+#include <relative_localization/line_ransac.h>
+#include <relative_localization/se2_pose_filter.h>
+
 
 class ReferenceLocalization
 {
@@ -92,15 +103,86 @@ public:
 
 protected:
 
+	// state of a wall line that is tracked over consecutive scans
+	struct WallTrack
+	{
+		WallTrack() : valid_(false), reference_inliers_(0) {}
+
+		bool valid_;
+		cv::Vec4d line_;			// wall line of the last scan in the base frame
+		ros::Time stamp_;			// time stamp of the last scan
+		int reference_inliers_;		// number of inliers of the last global RANSAC estimate
+	};
+
+	// statistics of the scan processing pipeline since the last report
+	struct ScanStatistics
+	{
+		ScanStatistics() : received_(0), lost_(0), decimated_(0), dropped_(0), processed_(0),
+				latency_sum_(0.), latency_max_(0.), processing_time_sum_(0.), processing_time_max_(0.) {}
+
+		unsigned int received_;		// scans received by the subscriber
+		unsigned int lost_;			// scans lost before reaching the subscriber (gaps in the header sequence numbers)
+		unsigned int decimated_;	// scans skipped by scan_decimation or max_processing_rate
+		unsigned int dropped_;		// scans replaced by a newer scan before the processing thread took them
+		unsigned int processed_;
+		double latency_sum_;		// time from the scan time stamp to the end of its processing, in [s]
+		double latency_max_;
+		double processing_time_sum_;	// in [s]
+		double processing_time_max_;
+	};
+
+	// estimates the reference frame from a laser scan, implemented by the localization methods
 	virtual void callback(const sensor_msgs::LaserScan::ConstPtr& laser_scan_msg) = 0;
+
+	// subscriber callback, applies the decimation and hands the scan over to the processing thread (or processes it directly)
+	void scanCallback(const sensor_msgs::LaserScan::ConstPtr& laser_scan_msg);
+
+	// runs callback() and records latency and processing time
+	void processScan(const sensor_msgs::LaserScan::ConstPtr& laser_scan_msg);
+
+	// processes the latest pending scan, older scans are dropped
+	void processingThread();
+
+	// has to be called in the destructor of derived classes, before the object that callback() belongs to is destroyed
+	void stopProcessingThread();
+
+	// timer callback, reports and resets the scan statistics
+	void printScanStatistics(const ros::TimerEvent& event);
 	virtual void dynamicReconfigureCallback(robotino_calibration::RelativeLocalizationConfig& config, uint32_t level);
 
 	// search for front wall until a suitable estimate is found, i.e. when scalar product of line normal and robot's x-axis do not differ by more than 45deg angle
 	// scan_front the laser scan which contains all relevant points of the front wall (and possibly more points), this vector will be modified within the function
-	bool estimateFrontWall(std::vector<cv::Point2d>& scan_front, cv::Vec4d& line_front, const double inlier_ratio=0.1, const double success_probability=0.99999,
+	// the front wall of the previous scan is tracked first, the RANSAC search is only run if it is not supported by the scan anymore
+	bool estimateFrontWall(std::vector<cv::Point2d>& scan_front, cv::Vec4d& line_front, const ros::Time& time_stamp, const double inlier_ratio=0.1, const double success_probability=0.99999,
 			const double inlier_distance=0.01, const int repetitions=10);
 
-	void computeAndPublishChildFrame(const cv::Vec4d& line, const cv::Point2d& corner_point, const std_msgs::Header::_stamp_type& time_stamp);
+	// tries to find the tracked wall line again in scan (moved by the odometry since the last scan, if available) and refines it by least squares,
+	// returns false if tracking is disabled, there is no valid track or the line lost too many inliers
+	bool trackWall(const std::vector<cv::Point2d>& scan, const WallTrack& track, const ros::Time& time_stamp, const double inlier_distance, cv::Vec4d& line);
+
+	// stores line as the new state of track, ransac_estimate = true if the line was obtained by a global RANSAC search
+	void updateWallTrack(WallTrack& track, const cv::Vec4d& line, const ros::Time& time_stamp, const bool ransac_estimate);
+
+	// transforms a line from the base frame at time from into the base frame at time to with the odometry, returns false if not possible
+	bool predictLineMotion(const ros::Time& from, const ros::Time& to, cv::Vec4d& line);
+
+	// motion = transform from the base frame at time from into the base frame at time to, measured by the odometry
+	// timeout = maximum time to wait for the odometry at time to, returns false if no odometry frame is set or the transform is not available
+	bool getBaseMotion(const ros::Time& from, const ros::Time& to, const ros::Duration& timeout, tf::StampedTransform& motion);
+
+	// moves the pose filter by the odometry motion since its last update
+	void predictPoseFilter(const ros::Time& time_stamp);
+
+	// timer callback, publishes the last child frame moved by the odometry since the last scan
+	void publishPredictedChildFrame(const ros::TimerEvent& event);
+
+	// line = front wall line with the variances of its position across the wall (at the line point) and of its direction, see LineRansac
+	// corner_variance = variance of the corner point position along the wall, in [m^2]
+	void computeAndPublishChildFrame(const cv::Vec4d& line, const double line_offset_variance, const double line_angle_variance,
+			const cv::Point2d& corner_point, const double corner_variance, const std_msgs::Header::_stamp_type& time_stamp);
+
+	// publishes the pose of the child frame in the base frame together with the covariance of the pose filter
+	void publishReferencePose(const tf::StampedTransform& reference_frame);
 
 	// only works for laser scanners mounted parallel to the ground, assuming that laser scanner frame and base_link have the same z-axis
 	void shiftReferenceFrameToGround(tf::StampedTransform& reference_frame);
@@ -111,6 +193,7 @@ protected:
 	ros::NodeHandle node_handle_;
 	ros::Subscriber laser_scan_sub_;
 	ros::Publisher marker_pub_;
+	ros::Publisher reference_pose_pub_;
 
 	tf::TransformBroadcaster transform_broadcaster_;
 	tf::TransformListener transform_listener_;
@@ -118,14 +201,47 @@ protected:
 	dynamic_reconfigure::Server<robotino_calibration::RelativeLocalizationConfig> dynamic_reconfigure_server_;
 	tf::Vector3 avg_translation_;
 	tf::Quaternion avg_orientation_;
+	Se2PoseFilter pose_filter_;		// filtered pose (x, y, yaw) of the child frame in the base frame
+	tf::StampedTransform reference_frame_;	// last child frame computed from a scan, before shifting it to the ground
+	bool reference_frame_valid_;
+	ros::Timer publish_timer_;
+	boost::mutex reference_frame_mutex_;	// guards reference_frame_, the averaged transform and the dynamic reconfigure parameters
+
+	// scan processing pipeline
+	boost::thread processing_thread_;
+	boost::mutex scan_mutex_;		// guards pending_scan_, stop_processing_ and the statistics
+	boost::condition_variable scan_condition_;
+	sensor_msgs::LaserScan::ConstPtr pending_scan_;		// latest scan waiting for the processing thread
+	bool stop_processing_;
+	unsigned int scan_counter_;
+	ros::Time last_accepted_scan_stamp_;
+	uint32_t last_scan_sequence_;
+	ScanStatistics scan_statistics_;
+	ros::Timer statistics_timer_;
 	double base_height_;
+	ScanProjector scan_projector_;	// converts the laser scans into base frame points
+	LineRansac line_ransac_;		// line estimator for the walls
+	WallTrack front_wall_track_;
 
 	// parameters
-	double update_rate_;
+	double update_rate_;		// only used if pose_filter_enabled_ is false
+	bool pose_filter_enabled_;	// if true, the child frame is filtered by pose_filter_, otherwise by an exponential moving average with update_rate_
 	std::string base_frame_;
 	std::string laser_scanner_topic_in_;
 	std::string child_frame_name_;
 	std::vector<cv::Point2f> front_wall_polygon_;
+	double polygon_mask_cell_size_;		// cell size of the rasterized detection polygons, in [m]
+	PolygonMask front_wall_mask_;		// rasterized front_wall_polygon_ for fast point in polygon tests
+	int random_seed_;		// seed of the RANSAC sampling, a negative value seeds with the current time (non-deterministic results)
+	bool wall_tracking_;	// if true, the walls of the previous scan are refit to the new scan before a global RANSAC search is started
+	double wall_tracking_min_inlier_ratio_;	// a tracked wall is lost if it has less than this ratio of the inliers of its last RANSAC estimate
+	std::string odometry_frame_;	// fixed frame of the odometry used for moving tracked walls and the pose filter between scans, no motion compensation if empty
+	double odometry_noise_ratio_;	// standard deviation of the odometry as ratio of the measured motion
+	double publish_rate_;		// [Hz] rate at which the child frame is published with odometry prediction between scans, 0 = only publish on scans
+	bool use_processing_thread_;	// if true, scans are processed by a dedicated thread that always takes the latest scan
+	int scan_decimation_;		// only every scan_decimation_-th scan is processed
+	double max_processing_rate_;	// [Hz] maximum rate of processed scans, 0 = no limit
+	double statistics_period_;	// [s] period of the scan statistics report, 0 = no report
 };
 
 
@@ -77,6 +77,7 @@ BoxLocalization::BoxLocalization(ros::NodeHandle& nh)
 		box_search_polygon_.push_back(cv::Point2f(temp[2*i], temp[2*i+1]));
 		std::cout << temp[2*i] << "\t" << temp[2*i+1] << std::endl;
 	}
+	box_search_mask_.setPolygon(box_search_polygon_, polygon_mask_cell_size_);
 
 	ROS_INFO("BoxLocalization: Initialized.");
 	initialized_ = true;
@@ -84,6 +85,8 @@ BoxLocalization::BoxLocalization(ros::NodeHandle& nh)
 
 BoxLocalization::~BoxLocalization()
 {
+	// callback() must not run anymore once this object is destroyed
+	stopProcessingThread();
 }
 
 //#define DEBUG_OUTPUT
@@ -108,36 +111,34 @@ void BoxLocalization::callback(const sensor_msgs::LaserScan::ConstPtr& laser_sca
 		return;
 	}
 
-	// convert scan to x-y coordinates
+	// convert scan to x-y coordinates in the base frame
+	scan_projector_.project(laser_scan_msg->ranges, laser_scan_msg->angle_min, laser_scan_msg->angle_increment, T);
 	std::vector<cv::Point2d> scan_front;
 	std::vector<cv::Point2d> scan_all;
-	for (unsigned int i = 0; i < laser_scan_msg->ranges.size(); ++i)
+	scan_all.reserve(scan_projector_.size());
+	for (size_t i = 0; i < scan_projector_.size(); ++i)
 	{
-		double angle = laser_scan_msg->angle_min + i * laser_scan_msg->angle_increment; // [rad]
-		double dist = laser_scan_msg->ranges[i]; // [m]
-
-		// transform laser scanner points to base frame
-		cv::Mat point_laser(cv::Vec4d(dist*cos(angle), dist*sin(angle), 0, 1.0));
-		cv::Mat point_base_mat = T*point_laser;
-		cv::Point2f point_2d_base(point_base_mat.at<double>(0), point_base_mat.at<double>(1));
+		const cv::Point2d point_base = scan_projector_.point(i);
 
 		// Check if point is inside polygon and push to scan if that's the case
-		if (cv::pointPolygonTest(front_wall_polygon_, point_2d_base, false) >= 0.f) // front wall points
-			scan_front.push_back(point_2d_base);
+		if (front_wall_mask_.contains(point_base.x, point_base.y)) // front wall points
+			scan_front.push_back(point_base);
 
-		scan_all.push_back(point_2d_base);
+		scan_all.push_back(point_base);
 	}
 
 	// ---------- 2. front wall estimation ----------
 	// search for front wall until a suitable estimate is found, i.e. when scalar product of line normal and robot's x-axis do not differ by more than 45deg angle
 	const double inlier_distance = 0.01;
 	cv::Vec4d line_front;
-	bool found_front_line = estimateFrontWall(scan_front, line_front, 0.1, 0.99999, inlier_distance, 10);
+	bool found_front_line = estimateFrontWall(scan_front, line_front, laser_scan_msg->header.stamp, 0.1, 0.99999, inlier_distance, 10);
 	if (found_front_line == false)
 	{
 		ROS_WARN("BoxLocalization::callback: front wall could not be estimated.");
 		return;
 	}
+	const double front_offset_variance = line_ransac_.getOffsetVariance();
+	const double front_angle_variance = line_ransac_.getAngleVariance();
 	// display line
 	const double px = line_front.val[0];	// coordinates of a point on the wall
 	const double py = line_front.val[1];
@@ -155,7 +156,7 @@ void BoxLocalization::callback(const sensor_msgs::LaserScan::ConstPtr& laser_sca
 	for (unsigned int i = 0; i < scan_all.size(); ++i)
 	{
 		//double distance_to_robot = scan[i].x*scan[i].x + scan[i].y*scan[i].y;
-		if (cv::pointPolygonTest(box_search_polygon_, scan_all[i], false) >= 0 )	// only search for block inside search polygon
+		if (box_search_mask_.contains(scan_all[i].x, scan_all[i].y))	// only search for block inside search polygon
 		{
 			double d = fabs(n0x*(scan_all[i].x-px) + n0y*(scan_all[i].y-py));		// distance to wall
 			if (d<0.1 && in_reflector_segment==true)
@@ -201,7 +202,11 @@ void BoxLocalization::callback(const sensor_msgs::LaserScan::ConstPtr& laser_sca
 	// ---------- 4. publish tf ----------
 	// determine coordinate system generated by block in front of a wall
 	// block coordinate system is attached at the left corner of the block directly on the wall surface
-	computeAndPublishChildFrame(line_front, corner_point, laser_scan_msg->header.stamp);
+	// the box edge lies between the last box point and the next beam, i.e. it is uniformly distributed within one beam spacing
+	const double laser_dx = corner_point.x - T.at<double>(0,3);
+	const double laser_dy = corner_point.y - T.at<double>(1,3);
+	const double beam_spacing = sqrt(laser_dx*laser_dx + laser_dy*laser_dy) * laser_scan_msg->angle_increment;
+	computeAndPublishChildFrame(line_front, front_offset_variance, front_angle_variance, corner_point, beam_spacing*beam_spacing/12., laser_scan_msg->header.stamp);
 }
 
 // reflector-based
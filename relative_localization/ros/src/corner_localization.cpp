@@ -78,6 +78,10 @@ CornerLocalization::CornerLocalization(ros::NodeHandle& nh)
 		side_wall_polygon_.push_back(cv::Point2f(temp[2*i], temp[2*i+1]));
 		std::cout << temp[2*i] << "\t" << temp[2*i+1] << std::endl;
 	}
+	side_wall_mask_.setPolygon(side_wall_polygon_, polygon_mask_cell_size_);
+	node_handle_.param("joint_corner_fit", joint_corner_fit_, true);
+	std::cout << "joint_corner_fit: " << joint_corner_fit_ << std::endl;
+	corner_ransac_.setSeed(random_seed_ >= 0 ? (uint64_t)random_seed_ : ros::WallTime::now().toNSec(), 1);
 
 	ROS_INFO("CornerLocalization: Initialized.");
 	initialized_ = true;
@@ -85,6 +89,8 @@ CornerLocalization::CornerLocalization(ros::NodeHandle& nh)
 
 CornerLocalization::~CornerLocalization()
 {
+	// callback() must not run anymore once this object is destroyed
+	stopProcessingThread();
 }
 
 //#define DEBUG_OUTPUT
@@ -110,70 +116,119 @@ void CornerLocalization::callback(const sensor_msgs::LaserScan::ConstPtr& laser_
 	}
 
 	// retrieve points from side and front wall and put each of those in separate lists
+	scan_projector_.project(laser_scan_msg->ranges, laser_scan_msg->angle_min, laser_scan_msg->angle_increment, T);
 	std::vector<cv::Point2d> scan_front;
 	std::vector<cv::Point2d> scan_side_all;
-	for (size_t i=0; i<laser_scan_msg->ranges.size(); i++ )
+	for (size_t i=0; i<scan_projector_.size(); i++ )
 	{
-		double angle = laser_scan_msg->angle_min + i * laser_scan_msg->angle_increment; // [rad]
-		double dist = laser_scan_msg->ranges[i]; // [m]
-
-		// transform laser scanner points to base frame
-		cv::Mat point_laser(cv::Vec4d(dist*cos(angle), dist*sin(angle), 0, 1.0));
-		cv::Mat point_base_mat = T*point_laser;
-		cv::Point2f point_2d_base(point_base_mat.at<double>(0), point_base_mat.at<double>(1));
+		const cv::Point2d point_base = scan_projector_.point(i);
 
 		// check if point is inside front wall polygon and push to scan_front if that's the case
-		if (cv::pointPolygonTest(front_wall_polygon_, point_2d_base, false) >= 0.f) // front wall points
-			scan_front.push_back(point_2d_base);
+		if (front_wall_mask_.contains(point_base.x, point_base.y)) // front wall points
+			scan_front.push_back(point_base);
 
 		// store all points from the side polygon in here, use distance measure to front wall later to exclude front wall points
-		if (cv::pointPolygonTest(side_wall_polygon_, point_2d_base, false) >= 0.f) // side wall points
-			scan_side_all.push_back(point_2d_base);
+		if (side_wall_mask_.contains(point_base.x, point_base.y)) // side wall points
+			scan_side_all.push_back(point_base);
 	}
 
-	// ---------- 2. front wall estimation ----------
-	// search for front wall until a suitable estimate is found, i.e. when scalar product of line normal and robot's x-axis do not differ by more than 45deg angle
+	// ---------- 2. + 3. front and side wall estimation ----------
 	const double inlier_distance = 0.01;
-	cv::Vec4d line_front;
-	bool found_front_line = estimateFrontWall(scan_front, line_front, 0.1, 0.99999, inlier_distance, 10);
-	if (found_front_line == false)
-	{
-		ROS_WARN("CornerLocalization::callback: front wall could not be estimated.");
+	cv::Vec4d line_front, line_side;
+	WallVariances variances;
+	const bool found_walls = (joint_corner_fit_ == true ?
+			estimateWallsJointly(scan_front, scan_side_all, laser_scan_msg->header.stamp, inlier_distance, line_front, line_side, variances) :
+			estimateWallsSequentially(scan_front, scan_side_all, laser_scan_msg->header.stamp, inlier_distance, line_front, line_side, variances));
+	if (found_walls == false)
 		return;
-	}
+
 	const double px_f = line_front.val[0];	// coordinates of a point on front the wall
 	const double py_f = line_front.val[1];
 	const double n0x_f = line_front.val[2];	// normal direction on the front wall (in floor plane x-y)
 	const double n0y_f = line_front.val[3];
+	const double px_s = line_side.val[0];	// coordinates of a point on the side wall
+	const double py_s = line_side.val[1];
+	const double n0x_s = line_side.val[2];	// normal direction on the side wall (in floor plane x-y)
+	const double n0y_s = line_side.val[3];
 
+	// display lines
 	if (marker_pub_.getNumSubscribers() > 0)
+	{
 		VisualizationUtilities::publishWallVisualization(laser_scan_msg->header, "wall_front", px_f, py_f, n0x_f, n0y_f, marker_pub_);
+		VisualizationUtilities::publishWallVisualization(laser_scan_msg->header, "wall_side", px_s, py_s, n0x_s, n0y_s, marker_pub_);
+	}
 
-	// ---------- 3. side wall estimation ----------
-	std::vector<cv::Point2d> scan_side;
-	for ( size_t i=0; i<scan_side_all.size(); i++ )
+	// ---------- 4. publish tf ----------
+	// compute intersection of two wall segments
+	cv::Point2d corner_point;
+	const double a = n0x_f*px_f+n0y_f*py_f;
+	const double b = n0x_s*px_s+n0y_s*py_s;
+	corner_point.y = (a*n0x_s-b*n0x_f) / (n0y_f*n0x_s-n0x_f*n0y_s);
+	if (fabs(n0x_f) > fabs(n0x_s))
+		corner_point.x = (a-n0y_f*corner_point.y) / n0x_f;
+	else
+		corner_point.x = (b-n0y_s*corner_point.y) / n0x_s;
+	if (corner_point.x == 0 && corner_point.y == 0)
+		return;
+
+	// display points of box segment
+	std::vector<cv::Point2d> corner_point_vec(1, corner_point);
+	if (marker_pub_.getNumSubscribers() > 0)
+		VisualizationUtilities::publishPointsVisualization(laser_scan_msg->header, "corner_point", corner_point_vec, marker_pub_);
+
+#ifdef DEBUG_OUTPUT
+	std::cout << "Corner point: " << corner_point << std::endl;
+#endif
+
+	// determine coordinate system generated by corner at the intersection of two walls (laser scanner coordinate system: x=forward, y=left, z=up)
+	// corner coordinate system is attached to the corner of the the walls
+	// the corner position along the front wall is determined by the side wall line, evaluated at the corner (lever arm j_s from the side wall's line point)
+	const double j_s = (corner_point.x-px_s)*n0y_s - (corner_point.y-py_s)*n0x_s;
+	const double corner_variance = variances.side_offset_ + j_s*j_s*variances.side_angle_;
+	computeAndPublishChildFrame(line_front, variances.front_offset_, variances.front_angle_, corner_point, corner_variance, laser_scan_msg->header.stamp);
+}
+
+bool CornerLocalization::estimateWallsSequentially(std::vector<cv::Point2d>& scan_front, const std::vector<cv::Point2d>& scan_side_all, const ros::Time& time_stamp,
+		const double inlier_distance, cv::Vec4d& line_front, cv::Vec4d& line_side, WallVariances& variances)
+{
+	// search for front wall until a suitable estimate is found, i.e. when scalar product of line normal and robot's x-axis do not differ by more than 45deg angle
+	bool found_front_line = estimateFrontWall(scan_front, line_front, time_stamp, 0.1, 0.99999, inlier_distance, 10);
+	if (found_front_line == false)
 	{
-		const double d = RelativeLocalizationUtilities::distanceToLine(px_f, py_f, n0x_f, n0y_f, scan_side_all[i].x, scan_side_all[i].y);	// distance to front wall line
-		if (d > 2*inlier_distance)
-			scan_side.push_back(scan_side_all[i]);
+		ROS_WARN("CornerLocalization::estimateWallsSequentially: front wall could not be estimated.");
+		return false;
 	}
+	variances.front_offset_ = line_ransac_.getOffsetVariance();
+	variances.front_angle_ = line_ransac_.getAngleVariance();
+	const double n0x_f = line_front.val[2];	// normal direction on the front wall (in floor plane x-y)
+	const double n0y_f = line_front.val[3];
+
+	// side wall candidates without the points of the front wall
+	std::vector<cv::Point2d> scan_side;
+	removeFrontWallPoints(scan_side_all, line_front, 2*inlier_distance, scan_side);
 
 	// search a side wall until one is found, which is not too distant and approximately perpendicular to the first
-	cv::Vec4d line_side;
 	bool found_side_line = false;
-	for (int i=0; i<10; ++i)
+	// refit the side wall of the last scan if it is still supported by enough points and perpendicular to the front wall
+	if (trackWall(scan_side, side_wall_track_, time_stamp, inlier_distance, line_side) == true && fabs(n0x_f*line_side.val[2] + n0y_f*line_side.val[3]) < 0.05)
+	{
+		found_side_line = true;
+		updateWallTrack(side_wall_track_, line_side, time_stamp, false);
+	}
+	for (int i=0; i<10 && found_side_line==false; ++i)
 	{
 		if (scan_side.size() < 2)
 		{
-			ROS_WARN("CornerLocalization::callback: no points left for estimating side wall.");
-			return;
+			ROS_WARN("CornerLocalization::estimateWallsSequentially: no points left for estimating side wall.");
+			side_wall_track_.valid_ = false;
+			return false;
 		}
 
 		// match line to scan_side
-		bool result = RelativeLocalizationUtilities::fitLine(scan_side, line_side, 0.1, 0.99999, inlier_distance, false);
+		bool result = line_ransac_.fitLine(scan_side, line_side, 0.1, 0.99999, inlier_distance, false);
 		if (!result || line_side.val[0] != line_side.val[0] || line_side.val[1] != line_side.val[1] || line_side.val[2] != line_side.val[2] || line_side.val[3] != line_side.val[3])
 		{
-			ROS_WARN("CornerLocalization::callback: side wall could not be estimated in trial %i. Trying next.", i);
+			ROS_WARN("CornerLocalization::estimateWallsSequentially: side wall could not be estimated in trial %i. Trying next.", i);
 			continue;
 		}
 
@@ -182,59 +237,75 @@ void CornerLocalization::callback(const sensor_msgs::LaserScan::ConstPtr& laser_
 		if (fabs(scalar_product) < 0.05)
 		{
 			found_side_line = true;
+			updateWallTrack(side_wall_track_, line_side, time_stamp, true);
 			break;
 		}
 
 		// remove points from last line
-		for (std::vector<cv::Point2d>::iterator it = scan_side.begin(); it!=scan_side.end(); )
-		{
-			const double dist = RelativeLocalizationUtilities::distanceToLine(line_side.val[0], line_side.val[1], line_side.val[2], line_side.val[3], it->x, it->y);
-			if (dist <= inlier_distance)
-				it = scan_side.erase(it);
-			else
-				++it;
-		}
+		RelativeLocalizationUtilities::removeLineInliers(scan_side, line_side, inlier_distance);
 	}
 	if (found_side_line == false)
 	{
-		ROS_WARN("CornerLocalization::callback: side wall could not be estimated.");
-		return;
+		ROS_WARN("CornerLocalization::estimateWallsSequentially: side wall could not be estimated.");
+		side_wall_track_.valid_ = false;
+		return false;
 	}
 
-	const double px_s = line_side.val[0];	// coordinates of a point on the side wall
-	const double py_s = line_side.val[1];
-	const double n0x_s = line_side.val[2];	// normal direction on the side wall (in floor plane x-y)
-	const double n0y_s = line_side.val[3];
-
-	// display line
-	if (marker_pub_.getNumSubscribers() > 0)
-		VisualizationUtilities::publishWallVisualization(laser_scan_msg->header, "wall_side", px_s, py_s, n0x_s, n0y_s, marker_pub_);
-
-	// ---------- 4. publish tf ----------
-	// compute intersection of two wall segments
-	cv::Point2d corner_point;
-	const double a = n0x_f*px_f+n0y_f*py_f;
-	const double b = n0x_s*px_s+n0y_s*py_s;
-	corner_point.y = (a*n0x_s-b*n0x_f) / (n0y_f*n0x_s-n0x_f*n0y_s);
-	if (fabs(n0x_f) > fabs(n0x_s))
-		corner_point.x = (a-n0y_f*corner_point.y) / n0x_f;
-	else
-		corner_point.x = (b-n0y_s*corner_point.y) / n0x_s;
-	if (corner_point.x == 0 && corner_point.y == 0)
-		return;
+	variances.side_offset_ = line_ransac_.getOffsetVariance();
+	variances.side_angle_ = line_ransac_.getAngleVariance();
+	return true;
+}
 
-	// display points of box segment
-	std::vector<cv::Point2d> corner_point_vec(1, corner_point);
-	if (marker_pub_.getNumSubscribers() > 0)
-		VisualizationUtilities::publishPointsVisualization(laser_scan_msg->header, "corner_point", corner_point_vec, marker_pub_);
+bool CornerLocalization::estimateWallsJointly(const std::vector<cv::Point2d>& scan_front, const std::vector<cv::Point2d>& scan_side_all, const ros::Time& time_stamp,
+		const double inlier_distance, cv::Vec4d& line_front, cv::Vec4d& line_side, WallVariances& variances)
+{
+	// refit both walls of the last scan if they are still supported by enough points and form a corner
+	if (trackWall(scan_front, front_wall_track_, time_stamp, inlier_distance, line_front) == true && fabs(line_front.val[2]) > 0.707)
+	{
+		variances.front_offset_ = line_ransac_.getOffsetVariance();
+		variances.front_angle_ = line_ransac_.getAngleVariance();
+		std::vector<cv::Point2d> scan_side;
+		removeFrontWallPoints(scan_side_all, line_front, 2*inlier_distance, scan_side);
+		if (trackWall(scan_side, side_wall_track_, time_stamp, inlier_distance, line_side) == true
+				&& fabs(line_front.val[2]*line_side.val[2] + line_front.val[3]*line_side.val[3]) < 0.05)
+		{
+			variances.side_offset_ = line_ransac_.getOffsetVariance();
+			variances.side_angle_ = line_ransac_.getAngleVariance();
+			updateWallTrack(front_wall_track_, line_front, time_stamp, false);
+			updateWallTrack(side_wall_track_, line_side, time_stamp, false);
+			return true;
+		}
+	}
 
-#ifdef DEBUG_OUTPUT
-	std::cout << "Corner point: " << corner_point << std::endl;
-#endif
+	// fit the L-shaped corner model to both point sets at once, the front wall points in scan_side_all are excluded from the side wall by CornerRansac
+	// (the front wall line is not known before the fit, so removeFrontWallPoints cannot be applied here)
+	if (corner_ransac_.fitCorner(scan_front, scan_side_all, line_front, line_side, 0.2, 0.99999, inlier_distance, 0.707) == false)
+	{
+		ROS_WARN("CornerLocalization::estimateWallsJointly: corner could not be estimated.");
+		front_wall_track_.valid_ = false;
+		side_wall_track_.valid_ = false;
+		return false;
+	}
+	variances.front_offset_ = corner_ransac_.getFrontOffsetVariance();
+	variances.front_angle_ = corner_ransac_.getAngleVariance();
+	variances.side_offset_ = corner_ransac_.getSideOffsetVariance();
+	variances.side_angle_ = corner_ransac_.getAngleVariance();
+	updateWallTrack(front_wall_track_, line_front, time_stamp, false);
+	front_wall_track_.reference_inliers_ = corner_ransac_.getFrontInliers();
+	updateWallTrack(side_wall_track_, line_side, time_stamp, false);
+	side_wall_track_.reference_inliers_ = corner_ransac_.getSideInliers();
+	return true;
+}
 
-	// determine coordinate system generated by corner at the intersection of two walls (laser scanner coordinate system: x=forward, y=left, z=up)
-	// corner coordinate system is attached to the corner of the the walls
-	computeAndPublishChildFrame(line_front, corner_point, laser_scan_msg->header.stamp);
+void CornerLocalization::removeFrontWallPoints(const std::vector<cv::Point2d>& scan_side_all, const cv::Vec4d& line_front, const double min_distance, std::vector<cv::Point2d>& scan_side)
+{
+	scan_side.clear();
+	for ( size_t i=0; i<scan_side_all.size(); i++ )
+	{
+		const double d = RelativeLocalizationUtilities::distanceToLine(line_front.val[0], line_front.val[1], line_front.val[2], line_front.val[3], scan_side_all[i].x, scan_side_all[i].y);	// distance to front wall line
+		if (d > min_distance)
+			scan_side.push_back(scan_side_all[i]);
+	}
 }
 
 void CornerLocalization::dynamicReconfigureCallback(robotino_calibration::RelativeLocalizationConfig &config, uint32_t level)
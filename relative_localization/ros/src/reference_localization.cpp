@@ -61,7 +61,8 @@
 
 
 ReferenceLocalization::ReferenceLocalization(ros::NodeHandle& nh)
-		: node_handle_(nh), transform_listener_(nh), initialized_(false)
+		: node_handle_(nh), transform_listener_(nh), initialized_(false), reference_frame_valid_(false), stop_processing_(false),
+		  scan_counter_(0), last_scan_sequence_(0)
 {
 	// load parameters
 	std::cout << "\n========== Reference Localization Parameters ==========\n";
@@ -75,6 +76,45 @@ ReferenceLocalization::ReferenceLocalization(ros::NodeHandle& nh)
 	std::cout << "base_frame: " << base_frame_ << std::endl;
 	node_handle_.param("base_height", base_height_, 0.0);
 	std::cout << "base_height: " << base_height_ << std::endl;
+	node_handle_.param("polygon_mask_cell_size", polygon_mask_cell_size_, 0.02);
+	std::cout << "polygon_mask_cell_size: " << polygon_mask_cell_size_ << std::endl;
+	node_handle_.param("random_seed", random_seed_, 0);
+	std::cout << "random_seed: " << random_seed_ << std::endl;
+	line_ransac_.setSeed(random_seed_ >= 0 ? (uint64_t)random_seed_ : ros::WallTime::now().toNSec());
+	node_handle_.param("wall_tracking", wall_tracking_, true);
+	std::cout << "wall_tracking: " << wall_tracking_ << std::endl;
+	node_handle_.param("wall_tracking_min_inlier_ratio", wall_tracking_min_inlier_ratio_, 0.8);
+	std::cout << "wall_tracking_min_inlier_ratio: " << wall_tracking_min_inlier_ratio_ << std::endl;
+	node_handle_.param<std::string>("odometry_frame", odometry_frame_, "");
+	std::cout << "odometry_frame: " << odometry_frame_ << std::endl;
+	node_handle_.param("odometry_noise_ratio", odometry_noise_ratio_, 0.05);
+	std::cout << "odometry_noise_ratio: " << odometry_noise_ratio_ << std::endl;
+	node_handle_.param("publish_rate", publish_rate_, 0.);
+	std::cout << "publish_rate: " << publish_rate_ << std::endl;
+	node_handle_.param("processing_thread", use_processing_thread_, true);
+	std::cout << "processing_thread: " << use_processing_thread_ << std::endl;
+	node_handle_.param("scan_decimation", scan_decimation_, 1);
+	std::cout << "scan_decimation: " << scan_decimation_ << std::endl;
+	node_handle_.param("max_processing_rate", max_processing_rate_, 0.);
+	std::cout << "max_processing_rate: " << max_processing_rate_ << std::endl;
+	node_handle_.param("statistics_period", statistics_period_, 10.);
+	std::cout << "statistics_period: " << statistics_period_ << std::endl;
+	node_handle_.param("pose_filter", pose_filter_enabled_, true);
+	std::cout << "pose_filter: " << pose_filter_enabled_ << std::endl;
+	double translation_noise = 0.05;
+	node_handle_.param("pose_filter_translation_noise", translation_noise, 0.05);
+	std::cout << "pose_filter_translation_noise: " << translation_noise << std::endl;
+	double rotation_noise = 0.05;
+	node_handle_.param("pose_filter_rotation_noise", rotation_noise, 0.05);
+	std::cout << "pose_filter_rotation_noise: " << rotation_noise << std::endl;
+	double outlier_gate = 16.27;
+	node_handle_.param("pose_filter_outlier_gate", outlier_gate, 16.27);
+	std::cout << "pose_filter_outlier_gate: " << outlier_gate << std::endl;
+	int max_outliers = 5;
+	node_handle_.param("pose_filter_max_outliers", max_outliers, 5);
+	std::cout << "pose_filter_max_outliers: " << max_outliers << std::endl;
+	pose_filter_.setProcessNoise(translation_noise, rotation_noise);
+	pose_filter_.setOutlierGate(outlier_gate, max_outliers);
 
 	// read out user-defined polygon that defines the area of laser scanner points being taken into account for front wall detection
 	std::vector<double> temp;
@@ -91,12 +131,29 @@ ReferenceLocalization::ReferenceLocalization(ros::NodeHandle& nh)
 		front_wall_polygon_.push_back(cv::Point2f(temp[2*i], temp[2*i+1]));
 		std::cout << temp[2*i] << "\t" << temp[2*i+1] << std::endl;
 	}
+	front_wall_mask_.setPolygon(front_wall_polygon_, polygon_mask_cell_size_);
 
 	// publishers
 	marker_pub_ = node_handle_.advertise<visualization_msgs::Marker>("wall_marker", 1);
+	reference_pose_pub_ = node_handle_.advertise<geometry_msgs::PoseWithCovarianceStamped>("reference_pose", 1);
 
-	// subscribers
-	laser_scan_sub_ = node_handle_.subscribe(laser_scanner_topic_in_, 0, &ReferenceLocalization::callback, this);
+	// subscribers, only the latest scan is of interest
+	laser_scan_sub_ = node_handle_.subscribe(laser_scanner_topic_in_, 1, &ReferenceLocalization::scanCallback, this);
+
+	// the processing thread waits for the first scan, i.e. it does not call callback() before the derived class is constructed
+	if (use_processing_thread_ == true)
+		processing_thread_ = boost::thread(boost::bind(&ReferenceLocalization::processingThread, this));
+
+	// timers
+	if (statistics_period_ > 0.)
+		statistics_timer_ = node_handle_.createTimer(ros::Duration(statistics_period_), &ReferenceLocalization::printScanStatistics, this);
+	if (publish_rate_ > 0.)
+	{
+		if (odometry_frame_.empty() == false)
+			publish_timer_ = node_handle_.createTimer(ros::Duration(1./publish_rate_), &ReferenceLocalization::publishPredictedChildFrame, this);
+		else
+			ROS_WARN("ReferenceLocalization: publish_rate is set but no odometry_frame is given, the child frame is only published on new scans.");
+	}
 
 	// dynamic reconfigure
 	dynamic_reconfigure_server_.setCallback(boost::bind(&ReferenceLocalization::dynamicReconfigureCallback, this, _1, _2));
@@ -107,19 +164,122 @@ ReferenceLocalization::ReferenceLocalization(ros::NodeHandle& nh)
 
 ReferenceLocalization::~ReferenceLocalization()
 {
+	stopProcessingThread();
+}
+
+void ReferenceLocalization::scanCallback(const sensor_msgs::LaserScan::ConstPtr& laser_scan_msg)
+{
+	{
+		boost::mutex::scoped_lock lock(scan_mutex_);
+		++scan_statistics_.received_;
+		if (scan_counter_ > 0 && laser_scan_msg->header.seq > last_scan_sequence_+1)
+			scan_statistics_.lost_ += laser_scan_msg->header.seq - last_scan_sequence_ - 1;
+		last_scan_sequence_ = laser_scan_msg->header.seq;
+
+		// decimation
+		const bool skip_scan = (scan_decimation_ > 1 && scan_counter_ % scan_decimation_ != 0) ||
+				(max_processing_rate_ > 0. && last_accepted_scan_stamp_.isZero() == false && laser_scan_msg->header.stamp >= last_accepted_scan_stamp_ &&
+				 (laser_scan_msg->header.stamp - last_accepted_scan_stamp_).toSec() < 1./max_processing_rate_);
+		++scan_counter_;
+		if (skip_scan == true)
+		{
+			++scan_statistics_.decimated_;
+			return;
+		}
+		last_accepted_scan_stamp_ = laser_scan_msg->header.stamp;
+
+		// hand over to the processing thread, a scan that has not been taken yet is replaced by the newer one
+		if (use_processing_thread_ == true)
+		{
+			if (pending_scan_)
+				++scan_statistics_.dropped_;
+			pending_scan_ = laser_scan_msg;
+			scan_condition_.notify_one();
+			return;
+		}
+	}
+
+	processScan(laser_scan_msg);
+}
+
+void ReferenceLocalization::processScan(const sensor_msgs::LaserScan::ConstPtr& laser_scan_msg)
+{
+	const ros::WallTime start = ros::WallTime::now();
+	callback(laser_scan_msg);
+	const double processing_time = (ros::WallTime::now() - start).toSec();
+	const double latency = (ros::Time::now() - laser_scan_msg->header.stamp).toSec();
+
+	boost::mutex::scoped_lock lock(scan_mutex_);
+	++scan_statistics_.processed_;
+	scan_statistics_.latency_sum_ += latency;
+	scan_statistics_.latency_max_ = std::max(scan_statistics_.latency_max_, latency);
+	scan_statistics_.processing_time_sum_ += processing_time;
+	scan_statistics_.processing_time_max_ = std::max(scan_statistics_.processing_time_max_, processing_time);
+}
+
+void ReferenceLocalization::processingThread()
+{
+	while (true)
+	{
+		sensor_msgs::LaserScan::ConstPtr laser_scan_msg;
+		{
+			boost::mutex::scoped_lock lock(scan_mutex_);
+			while (!pending_scan_ && stop_processing_ == false)
+				scan_condition_.wait(lock);
+			if (stop_processing_ == true)
+				return;
+			laser_scan_msg = pending_scan_;
+			pending_scan_.reset();
+		}
+		processScan(laser_scan_msg);
+	}
+}
+
+void ReferenceLocalization::stopProcessingThread()
+{
+	{
+		boost::mutex::scoped_lock lock(scan_mutex_);
+		stop_processing_ = true;
+		scan_condition_.notify_all();
+	}
+	if (processing_thread_.joinable())
+		processing_thread_.join();
+}
+
+void ReferenceLocalization::printScanStatistics(const ros::TimerEvent& event)
+{
+	ScanStatistics statistics;
+	{
+		boost::mutex::scoped_lock lock(scan_mutex_);
+		statistics = scan_statistics_;
+		scan_statistics_ = ScanStatistics();
+	}
+
+	const double processed = std::max(1u, statistics.processed_);
+	ROS_INFO("ReferenceLocalization: scans received: %u, lost: %u, decimated: %u, dropped: %u, processed: %u | latency avg: %.1f ms, max: %.1f ms | processing time avg: %.1f ms, max: %.1f ms",
+			statistics.received_, statistics.lost_, statistics.decimated_, statistics.dropped_, statistics.processed_,
+			1000.*statistics.latency_sum_/processed, 1000.*statistics.latency_max_, 1000.*statistics.processing_time_sum_/processed, 1000.*statistics.processing_time_max_);
 }
 
 void ReferenceLocalization::dynamicReconfigureCallback(robotino_calibration::RelativeLocalizationConfig &config, uint32_t level)
 {
+	boost::mutex::scoped_lock lock(reference_frame_mutex_);
 	update_rate_ = config.update_rate;
 	child_frame_name_ = config.child_frame_name;
 	std::cout << "Reconfigure request with\n update_rate=" << update_rate_
 			<< "\n child_frame_name=" << child_frame_name_ << "\n";
 }
 
-bool ReferenceLocalization::estimateFrontWall(std::vector<cv::Point2d>& scan_front, cv::Vec4d& line_front, const double inlier_ratio, const double success_probability,
+bool ReferenceLocalization::estimateFrontWall(std::vector<cv::Point2d>& scan_front, cv::Vec4d& line_front, const ros::Time& time_stamp, const double inlier_ratio, const double success_probability,
 		const double inlier_distance, const int repetitions)
 {
+	// refit the front wall of the last scan if it is still supported by enough points
+	if (trackWall(scan_front, front_wall_track_, time_stamp, inlier_distance, line_front) == true && fabs(line_front.val[2]) > 0.707)
+	{
+		updateWallTrack(front_wall_track_, line_front, time_stamp, false);
+		return true;
+	}
+
 	// search for front wall until a suitable estimate is found, i.e. when scalar product of line normal and robot's x-axis do not differ by more than 45deg angle
 	bool found_front_line = false;
 	for (int i=0; i<repetitions; ++i)
@@ -131,7 +291,7 @@ bool ReferenceLocalization::estimateFrontWall(std::vector<cv::Point2d>& scan_fro
 		}
 
 		// match line to scan_front
-		bool result = RelativeLocalizationUtilities::fitLine(scan_front, line_front, 0.1, 0.99999, inlier_distance, false);
+		bool result = line_ransac_.fitLine(scan_front, line_front, inlier_ratio, success_probability, inlier_distance, false);
 		if (!result || line_front.val[0] != line_front.val[0] || line_front.val[1] != line_front.val[1] || line_front.val[2] != line_front.val[2] || line_front.val[3] != line_front.val[3]) // check for NaN
 		{
 			ROS_WARN("ReferenceLocalization::estimateFrontWall: front wall could not be estimated in trial %i. Trying next.", i);
@@ -147,22 +307,53 @@ bool ReferenceLocalization::estimateFrontWall(std::vector<cv::Point2d>& scan_fro
 		}
 
 		// remove points from last line
-		for (std::vector<cv::Point2d>::iterator it = scan_front.begin(); it!=scan_front.end(); )
-		{
-			const double dist = RelativeLocalizationUtilities::distanceToLine(line_front.val[0], line_front.val[1], line_front.val[2], line_front.val[3], it->x, it->y);
-			if (dist <= inlier_distance)
-				it = scan_front.erase(it);
-			else
-				++it;
-		}
+		RelativeLocalizationUtilities::removeLineInliers(scan_front, line_front, inlier_distance);
 	}
 	if (found_front_line == false)
+	{
 		ROS_WARN("ReferenceLocalization::estimateFrontWall: front wall could not be estimated.");
+		front_wall_track_.valid_ = false;
+	}
+	else
+		updateWallTrack(front_wall_track_, line_front, time_stamp, true);
 
 	return found_front_line;
 }
 
-void ReferenceLocalization::computeAndPublishChildFrame(const cv::Vec4d& line, const cv::Point2d& corner_point, const std_msgs::Header::_stamp_type& time_stamp)
+bool ReferenceLocalization::trackWall(const std::vector<cv::Point2d>& scan, const WallTrack& track, const ros::Time& time_stamp, const double inlier_distance, cv::Vec4d& line)
+{
+	if (wall_tracking_ == false || track.valid_ == false)
+		return false;
+
+	cv::Vec4d predicted_line = track.line_;
+	predictLineMotion(track.stamp_, time_stamp, predicted_line);
+	const int min_inliers = std::max(2, (int)ceil(wall_tracking_min_inlier_ratio_*track.reference_inliers_));
+	return line_ransac_.refitLine(scan, predicted_line, inlier_distance, min_inliers, line);
+}
+
+void ReferenceLocalization::updateWallTrack(WallTrack& track, const cv::Vec4d& line, const ros::Time& time_stamp, const bool ransac_estimate)
+{
+	track.valid_ = true;
+	track.line_ = line;
+	track.stamp_ = time_stamp;
+	if (ransac_estimate == true)
+		track.reference_inliers_ = line_ransac_.getInliers();
+}
+
+bool ReferenceLocalization::predictLineMotion(const ros::Time& from, const ros::Time& to, cv::Vec4d& line)
+{
+	tf::StampedTransform motion;
+	if (from == to || getBaseMotion(from, to, ros::Duration(0.05), motion) == false)
+		return false;
+
+	const tf::Vector3 point = motion * tf::Vector3(line.val[0], line.val[1], 0.);
+	const tf::Vector3 normal = motion.getBasis() * tf::Vector3(line.val[2], line.val[3], 0.);
+	line = cv::Vec4d(point.x(), point.y(), normal.x(), normal.y());
+	return true;
+}
+
+void ReferenceLocalization::computeAndPublishChildFrame(const cv::Vec4d& line, const double line_offset_variance, const double line_angle_variance,
+		const cv::Point2d& corner_point, const double corner_variance, const std_msgs::Header::_stamp_type& time_stamp)
 {
 	// block coordinate system is attached at the left corner of the block directly on the wall surface
 	bool publish_tf = true;
@@ -189,8 +380,28 @@ void ReferenceLocalization::computeAndPublishChildFrame(const cv::Vec4d& line, c
 	double angle = atan2(normal.y, normal.x);
 	tf::Quaternion orientation(tf::Vector3(0,0,1), angle); // rotation around z by value of angle
 
+	// move the pose filter with the odometry since the last scan
+	if (pose_filter_enabled_ == true)
+		predictPoseFilter(time_stamp);
+
 	// update transform
-	if (avg_translation_.isZero())
+	boost::mutex::scoped_lock lock(reference_frame_mutex_);
+	if (pose_filter_enabled_ == true)
+	{
+		// measurement covariance in the wall coordinates (normal n0, tangent t = [n0y, -n0x]): across the wall from the line fit,
+		// where a direction error moves the frame origin by the lever arm j, along the wall from the corner point
+		const double normal_variance = line_offset_variance + j*j*line_angle_variance;
+		const cv::Matx33d measurement_covariance(
+				normal_variance*n0x*n0x + corner_variance*n0y*n0y, (normal_variance-corner_variance)*n0x*n0y, j*line_angle_variance*n0x,
+				(normal_variance-corner_variance)*n0x*n0y, normal_variance*n0y*n0y + corner_variance*n0x*n0x, j*line_angle_variance*n0y,
+				j*line_angle_variance*n0x, j*line_angle_variance*n0y, line_angle_variance);
+		if (pose_filter_.update(time_stamp.toSec(), cv::Vec3d(x, y, angle), measurement_covariance) == false)
+			ROS_WARN("ReferenceLocalization::computeAndPublishChildFrame: measurement rejected as outlier by the pose filter.");
+		const cv::Vec3d& pose = pose_filter_.getState();
+		avg_translation_ = tf::Vector3(pose[0], pose[1], 0.);
+		avg_orientation_ = tf::Quaternion(tf::Vector3(0,0,1), pose[2]);
+	}
+	else if (avg_translation_.isZero())
 	{
 		// use value directly on first message
 		avg_translation_ = translation;
@@ -210,13 +421,95 @@ void ReferenceLocalization::computeAndPublishChildFrame(const cv::Vec4d& line, c
 	transform_table_reference.setOrigin(avg_translation_);
 	transform_table_reference.setRotation(avg_orientation_);
 	tf::StampedTransform tf_msg(transform_table_reference, time_stamp, base_frame_, child_frame_name_);
+	reference_frame_ = tf_msg;
+	reference_frame_valid_ = true;
 	shiftReferenceFrameToGround(tf_msg);
 
 	// publish coordinate system on tf
 	if (publish_tf == true)
 	{
 		transform_broadcaster_.sendTransform(tf_msg);
+		if (pose_filter_enabled_ == true)
+			publishReferencePose(tf_msg);
+	}
+}
+
+void ReferenceLocalization::publishReferencePose(const tf::StampedTransform& reference_frame)
+{
+	if (reference_pose_pub_.getNumSubscribers() == 0)
+		return;
+
+	geometry_msgs::PoseWithCovarianceStamped msg;
+	msg.header.stamp = reference_frame.stamp_;
+	msg.header.frame_id = reference_frame.frame_id_;
+	tf::poseTFToMsg(reference_frame, msg.pose.pose);
+
+	// 6x6 covariance in row-major order (x, y, z, roll, pitch, yaw), only the planar part is estimated
+	const cv::Matx33d& covariance = pose_filter_.getCovariance();
+	const int index[3] = {0, 1, 5};
+	for (int v=0; v<3; ++v)
+		for (int u=0; u<3; ++u)
+			msg.pose.covariance[6*index[v]+index[u]] = covariance(v,u);
+	reference_pose_pub_.publish(msg);
+}
+
+bool ReferenceLocalization::getBaseMotion(const ros::Time& from, const ros::Time& to, const ros::Duration& timeout, tf::StampedTransform& motion)
+{
+	if (odometry_frame_.empty() == true)
+		return false;
+
+	// transform from the base frame at time from into the base frame at time to, using the odometry frame as fixed frame
+	try
+	{
+		if (timeout > ros::Duration(0))
+			transform_listener_.waitForTransform(base_frame_, to, base_frame_, from, odometry_frame_, timeout);
+		transform_listener_.lookupTransform(base_frame_, to, base_frame_, from, odometry_frame_, motion);
+	}
+	catch (tf::TransformException& ex)
+	{
+		ROS_WARN_THROTTLE(1.0, "ReferenceLocalization::getBaseMotion: %s", ex.what());
+		return false;
+	}
+	return true;
+}
+
+void ReferenceLocalization::predictPoseFilter(const ros::Time& time_stamp)
+{
+	tf::StampedTransform motion;
+	if (pose_filter_.isInitialized() == false || reference_frame_valid_ == false || getBaseMotion(reference_frame_.stamp_, time_stamp, ros::Duration(0.05), motion) == false)
+		return;
+
+	// odometry noise proportional to the driven distance and rotation
+	const double dx = motion.getOrigin().x();
+	const double dy = motion.getOrigin().y();
+	const double dyaw = tf::getYaw(motion.getRotation());
+	const double translation_variance = odometry_noise_ratio_*odometry_noise_ratio_*(dx*dx + dy*dy);
+	const double rotation_variance = odometry_noise_ratio_*odometry_noise_ratio_*dyaw*dyaw;
+	const cv::Matx33d motion_covariance(translation_variance, 0., 0., 0., translation_variance, 0., 0., 0., rotation_variance);
+	pose_filter_.predict(time_stamp.toSec(), cv::Vec3d(dx, dy, dyaw), motion_covariance);
+}
+
+void ReferenceLocalization::publishPredictedChildFrame(const ros::TimerEvent& event)
+{
+	tf::StampedTransform reference_frame;
+	{
+		boost::mutex::scoped_lock lock(reference_frame_mutex_);
+		if (reference_frame_valid_ == false)
+			return;
+		reference_frame = reference_frame_;
 	}
+
+	// only use odometry that is already available, the timer must not wait
+	ros::Time latest_odometry;
+	if (transform_listener_.getLatestCommonTime(odometry_frame_, base_frame_, latest_odometry, 0) != tf::NO_ERROR || latest_odometry <= reference_frame.stamp_)
+		return;
+	tf::StampedTransform motion;
+	if (getBaseMotion(reference_frame.stamp_, latest_odometry, ros::Duration(0), motion) == false)
+		return;
+
+	tf::StampedTransform tf_msg(motion * reference_frame, latest_odometry, base_frame_, reference_frame.child_frame_id_);
+	shiftReferenceFrameToGround(tf_msg);
+	transform_broadcaster_.sendTransform(tf_msg);
 }
 
 // only works for laser scanners mounted parallel to the ground, assuming that laser scanner frame and base_link have the same z-axis
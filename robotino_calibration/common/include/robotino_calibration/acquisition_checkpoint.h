@@ -0,0 +1,112 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+#ifndef ACQUISITION_CHECKPOINT_H_
+#define ACQUISITION_CHECKPOINT_H_
+
+#include <robotino_calibration/calibration_utilities.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+
+// Persistent record of the robot configurations that have been captured successfully during an acquisition session.
+// Every captured configuration is appended as a single line with one write and synced to disk, so an interrupted
+// session can be resumed by skipping the recorded configurations. The per-view data files themselves should be
+// written with commitFile to make sure a recorded configuration always refers to complete data.
+// The checkpoint header stores the number of configurations and a hash of the session description (marker type and
+// configuration values), a checkpoint is only resumed if both match the current motion plan.
+// markCaptured may be called from processing threads.
+class AcquisitionCheckpoint
+{
+public:
+
+	// file_name: checkpoint file, number_configurations: size of the motion plan of this session,
+	// session_description: identifies the motion plan, see describeSession
+	AcquisitionCheckpoint(const std::string& file_name, const int number_configurations, const std::string& session_description);
+	~AcquisitionCheckpoint();
+
+	// session descriptions of the camera calibration (robot configurations) and of the arm calibration (arm and camera joint angles)
+	static std::string describeSession(const std::string& marker_type, const std::vector<calibration_utilities::RobotConfiguration>& configurations);
+	static std::string describeSession(const std::string& marker_type, const std::vector<calibration_utilities::AngleConfiguration>& arm_configurations,
+			const std::vector<calibration_utilities::AngleConfiguration>& camera_configurations);
+
+	// reads the captured configurations from file, returns false if there is no checkpoint of a session with the same motion plan
+	bool load();
+
+	// discards all recorded configurations and starts a new session file
+	bool clear();
+
+	// appends the configuration index to the checkpoint file
+	bool markCaptured(const int configuration_index);
+
+	bool isCaptured(const int configuration_index) const;
+
+	// number of captured configurations
+	int getCapturedCount() const;
+
+	// syncs temp_file_name to disk and renames it to file_name, which replaces file_name atomically
+	static bool commitFile(const std::string& temp_file_name, const std::string& file_name);
+
+
+protected:
+
+	std::string file_name_;
+	int number_configurations_;
+	uint64_t session_hash_;		// FNV-1a hash of the session description
+	std::vector<bool> captured_;
+	mutable boost::mutex mutex_;		// secures captured_ and the appends to the checkpoint file
+};
+
+
+#endif /* ACQUISITION_CHECKPOINT_H_ */
@@ -0,0 +1,118 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+#ifndef ACQUISITION_PIPELINE_H_
+#define ACQUISITION_PIPELINE_H_
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/function.hpp>
+#include <deque>
+#include <string>
+
+
+// Overlaps robot motion with the processing of captured views. The acquisition loop runs the stages
+// move -> capture on the calling thread; capture freezes the image and the transforms of a view and hands
+// a processing job (detection, disk writes, checkpoint) to the pipeline, which executes it on worker threads
+// while the robot is already driving to the next configuration.
+// The job queue is bounded, enqueue blocks while it is full (backpressure). With 0 worker threads all jobs
+// are executed immediately on the calling thread, i.e. the acquisition runs strictly serially.
+class AcquisitionPipeline
+{
+public:
+
+	enum Stage {STAGE_MOVE=0, STAGE_CAPTURE, STAGE_QUEUE_WAIT, STAGE_PROCESS, NUMBER_STAGES};
+
+	AcquisitionPipeline(const int number_workers, const int queue_capacity);
+	~AcquisitionPipeline();		// finishes all queued jobs
+
+	// queues a processing job, blocks while the queue is full
+	void enqueue(const boost::function<void()>& job);
+
+	// blocks until all queued jobs have been processed
+	void waitUntilIdle();
+
+	// accumulates the duration of a stage, may be called from any thread
+	void addStageTime(const Stage stage, const double seconds);
+
+	// prints count, average and maximum duration of each stage
+	void printStatistics();
+
+	int getNumberWorkers() const;
+
+
+protected:
+
+	void workerLoop();
+
+	void runJob(const boost::function<void()>& job);
+
+	boost::mutex mutex_;
+	boost::condition_variable queue_not_full_;
+	boost::condition_variable queue_not_empty_;
+	boost::condition_variable idle_;
+	std::deque< boost::function<void()> > queue_;
+	int queue_capacity_;
+	int active_jobs_;		// jobs taken from the queue but not finished yet
+	bool shutdown_;
+	boost::thread_group workers_;
+	int number_workers_;
+
+	boost::mutex statistics_mutex_;
+	int stage_count_[NUMBER_STAGES];
+	double stage_time_sum_[NUMBER_STAGES];
+	double stage_time_max_[NUMBER_STAGES];
+};
+
+
+#endif /* ACQUISITION_PIPELINE_H_ */
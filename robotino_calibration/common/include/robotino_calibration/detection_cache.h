@@ -0,0 +1,112 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef DETECTION_CACHE_H_
+#define DETECTION_CACHE_H_
+
+#include <opencv2/opencv.hpp>
+#include <boost/thread/mutex.hpp>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+
+// Persistent cache of pattern detections for replayed sessions. An entry maps the hash of the image content combined with
+// the detector settings (e.g. pattern size and flags) to the detected corners, so a replay only runs the detector on images
+// it has not seen with the current settings. Changing any detector setting changes the key, i.e. old entries are not used anymore.
+// Failed detections are cached as well. Entries are appended to the cache file, an incomplete entry at its end is ignored.
+class DetectionCache
+{
+public:
+
+	DetectionCache();
+	~DetectionCache();
+
+	// loads the entries of file_name and appends new entries to it, the file is created if it does not exist
+	bool open(const std::string& file_name);
+
+	// 64 bit FNV-1a hash of data, seed allows chaining
+	static uint64_t hashData(const void* data, const size_t size, const uint64_t seed = 14695981039346656037ULL);
+
+	// hash of image size, type and pixel data
+	static uint64_t hashImage(const cv::Mat& image);
+
+	// returns true if an entry exists, found tells whether the detector succeeded on this image
+	bool lookup(const uint64_t image_hash, const std::string& detector_settings, bool& found, std::vector<cv::Point2f>& corners);
+
+	void insert(const uint64_t image_hash, const std::string& detector_settings, const bool found, const std::vector<cv::Point2f>& corners);
+
+	void printStatistics() const;
+
+
+protected:
+
+	struct Entry
+	{
+		bool found_;
+		std::vector<cv::Point2f> corners_;
+	};
+
+	static uint64_t computeKey(const uint64_t image_hash, const std::string& detector_settings);
+
+	std::map<uint64_t, Entry> entries_;
+	std::ofstream file_;
+	int hits_;
+	int misses_;
+	mutable boost::mutex mutex_;		// secures entries_, file_ and the statistics
+};
+
+
+#endif /* DETECTION_CACHE_H_ */
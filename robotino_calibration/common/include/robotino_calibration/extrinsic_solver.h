@@ -0,0 +1,81 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef EXTRINSIC_SOLVER_H_
+#define EXTRINSIC_SOLVER_H_
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+
+// Closed-form extrinsic calibration steps shared by the calibration nodes and the solver benchmark.
+// pattern_points_3d[i] are the pattern points (in pattern coordinates) observed in view i.
+namespace extrinsic_solver
+{
+	// estimates T_base_to_torso_lower from the marker points in base coordinates and their observation through the torso chain,
+	// using the current estimate of T_torso_upper_to_camera
+	cv::Mat estimateBaseToTorsoLower(const std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
+			const std::vector<cv::Mat>& T_base_to_marker_vector, const std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector,
+			const std::vector<cv::Mat>& T_camera_to_marker_vector, const cv::Mat& T_torso_upper_to_camera);
+
+	// estimates T_torso_upper_to_camera using the current estimate of T_base_to_torso_lower
+	cv::Mat estimateTorsoUpperToCamera(const std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
+			const std::vector<cv::Mat>& T_base_to_marker_vector, const std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector,
+			const std::vector<cv::Mat>& T_camera_to_marker_vector, const cv::Mat& T_base_to_torso_lower);
+
+	// estimates T_base_to_armbase from the checkerboard seen by the calibrated camera and the arm kinematics
+	cv::Mat estimateBaseToArmbase(const std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
+			const std::vector<cv::Mat>& T_base_to_checkerboard_vector, const std::vector<cv::Mat>& T_armbase_to_checkerboard_vector);
+}
+
+#endif /* EXTRINSIC_SOLVER_H_ */
@@ -0,0 +1,101 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef FIXED_RATE_LOOP_H_
+#define FIXED_RATE_LOOP_H_
+
+#include <boost/chrono.hpp>
+#include <string>
+
+
+// Paces a control loop at a fixed rate on the monotonic clock. The wake up times are multiples of the period after
+// reset(), so the period does not drift with the execution time of the loop body. If the body takes longer than
+// a period, the cycle is counted as overrun and the schedule restarts from the current time instead of trying
+// to catch up with a burst of short cycles.
+// Records the deviation of every wake up from its scheduled time (jitter).
+class FixedRateLoop
+{
+public:
+
+	// rate in [Hz]
+	FixedRateLoop(const double rate);
+
+	// starts a new schedule at the current time and clears the statistics
+	void reset();
+
+	// sleeps until the next period starts, returns false if the current cycle has overrun its period
+	bool sleep();
+
+	// prints number of cycles and overruns as well as average and maximum jitter
+	void printStatistics(const std::string& name) const;
+
+	int getCycleCount() const;
+	int getOverrunCount() const;
+	double getMaxJitter() const;		// [s]
+	double getPeriod() const;		// [s]
+
+
+protected:
+
+	typedef boost::chrono::steady_clock Clock;
+
+	Clock::duration period_;
+	Clock::time_point next_wakeup_;
+	int cycle_count_;
+	int overrun_count_;
+	double jitter_sum_;		// [s] sum of absolute wake up delays
+	double jitter_max_;		// [s]
+};
+
+
+#endif /* FIXED_RATE_LOOP_H_ */
@@ -0,0 +1,151 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef SESSION_ARCHIVE_H_
+#define SESSION_ARCHIVE_H_
+
+#include <opencv2/opencv.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+
+// Binary single-file storage of the views of an acquisition session, replaces the per-view image and yml files.
+// Layout: 16 byte file header followed by one record per view. A record is a fixed 32 byte header
+// (magic, view index, image size, element counts) followed by the 4x4 transforms (double), the 2d corners (float),
+// the '\n' separated labels and the encoded image, padded to a multiple of 8 bytes.
+// Records are only appended, a later record of the same view replaces an earlier one. An incomplete record at the end
+// of the file (interrupted write) is ignored by the reader and removed when the file is opened for appending.
+
+// one view of a session
+struct SessionArchiveRecord
+{
+	int view_index_;
+	cv::Size image_size_;
+	std::vector<cv::Mat> transforms_;		// 4x4 CV_64FC1, empty transforms are stored as zero matrix and restored as empty matrix
+	std::vector<cv::Point2f> corners_;
+	std::vector<std::string> labels_;
+	std::vector<uchar> image_data_;		// encoded image (png or jpeg thumbnail), empty if the image was not stored or not loaded
+
+	SessionArchiveRecord() : view_index_(-1) {}
+
+	// png encodes image into image_data_ and sets image_size_
+	bool encodeImage(const cv::Mat& image);
+
+	// stores a jpeg of image downscaled by scale in image_data_ (nothing if scale is 0), image_size_ is set to the size of the full image
+	bool encodeThumbnail(const cv::Mat& image, const double scale, const int jpeg_quality);
+
+	// decodes image_data_, flags as with cv::imdecode, returns false if no image is stored
+	bool decodeImage(cv::Mat& image, const int flags) const;
+};
+
+// appends records to a session archive, write may be called from processing threads
+class SessionArchiveWriter
+{
+public:
+
+	SessionArchiveWriter();
+	~SessionArchiveWriter();
+
+	// append=false starts a new archive, append=true continues an existing one (resumed session)
+	bool open(const std::string& file_name, const bool append);
+
+	void close();
+
+	// appends the record with a single write call and syncs it to disk
+	bool write(const SessionArchiveRecord& record);
+
+
+protected:
+
+	std::string file_name_;
+	int file_descriptor_;
+	boost::mutex mutex_;		// secures the appends to the archive file
+};
+
+// memory maps a session archive and reads transforms and corners of the views without parsing,
+// images are only copied out of the mapping on request
+class SessionArchiveReader
+{
+public:
+
+	SessionArchiveReader();
+
+	// maps the file and indexes its records, returns false if the file does not exist or is no session archive
+	bool open(const std::string& file_name);
+
+	bool hasView(const int view_index) const;
+
+	// copies the stored data of view_index into record, the encoded image is only copied if load_image is true
+	bool read(const int view_index, SessionArchiveRecord& record, const bool load_image) const;
+
+	// indices of all stored views in ascending order
+	std::vector<int> getViewIndices() const;
+
+	// size of the archive up to the end of the last complete record
+	size_t getValidSize() const;
+
+
+protected:
+
+	boost::interprocess::file_mapping file_;
+	boost::interprocess::mapped_region region_;
+	std::map<int, size_t> record_offsets_;		// view index -> offset of the latest record of this view
+	size_t valid_size_;
+};
+
+
+#endif /* SESSION_ARCHIVE_H_ */
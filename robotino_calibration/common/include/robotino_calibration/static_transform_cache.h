@@ -0,0 +1,117 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef STATIC_TRANSFORM_CACHE_H_
+#define STATIC_TRANSFORM_CACHE_H_
+
+#include <ros/ros.h>
+#include <tf/transform_listener.h>
+#include <tf/tfMessage.h>
+#include <opencv2/opencv.hpp>
+#include <boost/thread/mutex.hpp>
+#include <robotino_calibration/transformation_utilities.h>
+#include <map>
+#include <string>
+
+
+// Serves transforms between frames that are fixed by the robot description (e.g. camera_frame -> camera_optical_frame) from memory.
+// A frame pair is classified as static if all of its links come from /tf_static or if it was looked up with identical results
+// at stability_count different time stamps (for static transforms that are published periodically on /tf).
+// Only route frame pairs through the cache that are meant to be invariant, a moving pair which happens to rest during
+// stability_count lookups would be frozen as well.
+// The cache is cleared whenever a new /tf_static message arrives, e.g. after a restart of the robot_state_publisher.
+class StaticTransformCache
+{
+public:
+
+	StaticTransformCache(ros::NodeHandle nh, const tf::TransformListener& transform_listener);
+
+	// number of identical lookups at different time stamps needed to classify a pair that is published on /tf as static, 0 disables the stability check
+	void setStabilityCount(const int stability_count);
+
+	// returns the transform from target_frame to source_frame, static pairs are served from memory,
+	// all others are looked up at stamp with transform_utilities::getTransform
+	bool getTransform(const std::string& target_frame, const std::string& source_frame, const ros::Time& stamp, const ros::Duration& timeout, cv::Mat& T);
+
+	bool isStatic(const std::string& target_frame, const std::string& source_frame) const;
+
+	// forgets all cached transforms
+	void clear();
+
+
+protected:
+
+	struct CacheEntry
+	{
+		cv::Mat T_;					// last transform looked up for this pair
+		ros::Time stamp_;			// time stamp of the last lookup
+		int stable_count_;			// number of consecutive lookups at different time stamps that yielded T_
+		bool static_;				// T_ is valid at any time
+
+		CacheEntry() : stable_count_(0), static_(false) {}
+	};
+
+	void tfStaticCallback(const tf::tfMessage::ConstPtr& msg);
+
+	// true if the transforms are identical up to numerical noise
+	static bool isEqual(const cv::Mat& T1, const cv::Mat& T2);
+
+	const tf::TransformListener& transform_listener_;
+	ros::Subscriber tf_static_sub_;
+	int stability_count_;
+	std::map<transform_utilities::FramePair, CacheEntry> cache_;
+	mutable boost::mutex mutex_;		// secures cache_
+};
+
+
+#endif /* STATIC_TRANSFORM_CACHE_H_ */
@@ -0,0 +1,119 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef SYNTHETIC_OBSERVATIONS_H_
+#define SYNTHETIC_OBSERVATIONS_H_
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+
+// Generates calibration datasets with known ground truth for testing and benchmarking the extrinsic solvers offline.
+namespace synthetic_observations
+{
+	struct NoiseParameters
+	{
+		double translation_sigma_;		// standard deviation of the translation noise on each marker detection [m]
+		double rotation_sigma_;			// standard deviation of the rotation noise on each marker detection [rad]
+		double outlier_rate_;			// fraction of detections replaced by gross errors [0,1]
+		double outlier_translation_;	// maximum translation offset of an outlier [m]
+		double outlier_rotation_;		// maximum rotation offset of an outlier [rad]
+
+		NoiseParameters() :
+			translation_sigma_(0.002), rotation_sigma_(0.005), outlier_rate_(0.), outlier_translation_(0.2), outlier_rotation_(0.5)
+		{
+		}
+	};
+
+	// data layout as passed to extrinsic_solver::estimateBaseToTorsoLower/estimateTorsoUpperToCamera
+	struct CameraBaseDataset
+	{
+		std::vector< std::vector<cv::Point3f> > pattern_points_3d;
+		std::vector<cv::Mat> T_base_to_marker_vector;
+		std::vector<cv::Mat> T_torso_lower_to_torso_upper_vector;
+		std::vector<cv::Mat> T_camera_to_marker_vector;		// measured, i.e. with noise and outliers
+
+		cv::Mat T_base_to_torso_lower;		// ground truth
+		cv::Mat T_torso_upper_to_camera;	// ground truth
+	};
+
+	// data layout as passed to extrinsic_solver::estimateBaseToArmbase
+	struct ArmBaseDataset
+	{
+		std::vector< std::vector<cv::Point3f> > pattern_points_3d;
+		std::vector<cv::Mat> T_base_to_checkerboard_vector;		// measured, i.e. with noise and outliers
+		std::vector<cv::Mat> T_armbase_to_checkerboard_vector;
+
+		cv::Mat T_base_to_armbase;		// ground truth
+	};
+
+	// rotation matrix about a uniformly distributed random axis with angle drawn from N(0, sigma)
+	cv::Mat randomRotation(cv::RNG& rng, const double sigma);
+
+	// rotation matrix about a uniformly distributed random axis with angle drawn uniformly from [-max_angle, max_angle]
+	cv::Mat randomRotationUniform(cv::RNG& rng, const double max_angle);
+
+	// applies detection noise (or with probability outlier_rate_ a gross error) to the transform T
+	cv::Mat perturbTransform(const cv::Mat& T, cv::RNG& rng, const NoiseParameters& noise);
+
+	// pan/tilt torso observing a marker placed 1 to 2 m in front of the camera, noise is applied to the camera measurements
+	void generateCameraBaseDataset(const int number_observations, const NoiseParameters& noise, cv::RNG& rng, CameraBaseDataset& dataset);
+
+	// arm moving a checkerboard within its workspace, noise is applied to the camera measurements
+	void generateArmBaseDataset(const int number_observations, const NoiseParameters& noise, cv::RNG& rng, ArmBaseDataset& dataset);
+
+	// rotation error [deg] and translation error [m] between an estimated and a ground truth transform
+	void computeTransformError(const cv::Mat& T_estimate, const cv::Mat& T_truth, double& rotation_error, double& translation_error);
+}
+
+#endif /* SYNTHETIC_OBSERVATIONS_H_ */
@@ -74,9 +74,26 @@ namespace transform_utilities
 
 	//bool stringToTransform(const std::string& values, cv::Mat& trafo); // Takes a string like "1,1,1,1,1,1" and creates a 4x4 transformation matrix out of it.
 
+	// pair of target_frame and source_frame of a transform lookup
+	typedef std::pair<std::string, std::string> FramePair;
+
+	// converts a tf transform into a 4x4 transformation matrix
+	cv::Mat transformToMat(const tf::Transform& transform);
+
 	// computes the transform from target_frame to source_frame (i.e. transform arrow is pointing from target_frame to source_frame)
+	// uses the latest available transform and waits up to 1 s for it
 	bool getTransform(const tf::TransformListener& transform_listener, const std::string& target_frame, const std::string& source_frame, cv::Mat& T);
 
+	// computes the transform from target_frame to source_frame at time stamp (e.g. the header stamp of an image), waits at most timeout
+	// ros::Time(0) uses the latest available transform
+	bool getTransform(const tf::TransformListener& transform_listener, const std::string& target_frame, const std::string& source_frame,
+			const ros::Time& stamp, const ros::Duration& timeout, cv::Mat& T);
+
+	// computes the transforms of all frame pairs at the same time stamp, e.g. all transforms needed for one view
+	// the frame pairs share the wait budget timeout, with ros::Time(0) all transforms are taken at the latest instant available for all pairs
+	bool getTransforms(const tf::TransformListener& transform_listener, const std::vector<FramePair>& frame_pairs, const ros::Time& stamp,
+			const ros::Duration& timeout, std::vector<cv::Mat>& transforms);
+
 	// computes the rigid transform between two sets of corresponding 3d points measured in different coordinate systems
 	// the resulting 4x4 transformation matrix converts point coordinates from the target system into the source coordinate system
 	cv::Mat computeExtrinsicTransform(const std::vector<cv::Point3d>& points_3d_source, const std::vector<cv::Point3d>& points_3d_target);
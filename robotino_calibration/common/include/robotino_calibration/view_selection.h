@@ -0,0 +1,106 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+#ifndef VIEW_SELECTION_H_
+#define VIEW_SELECTION_H_
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+
+// Keeps the covariance of a linearized least squares estimate and scores candidate views by the
+// uncertainty reduction they are expected to yield. The model itself (parameters and measurement
+// Jacobians) is provided by the caller.
+class ViewSelection
+{
+public:
+
+	// prior_std: standard deviation of each parameter before any measurement, defines the parameter count
+	// measurement_std: standard deviation of a single scalar measurement residual
+	ViewSelection(const std::vector<double>& prior_std, const double measurement_std);
+	~ViewSelection();
+
+	// drops all observations, only the prior remains
+	void reset();
+
+	// adds the measurement Jacobian J (m x n, CV_64F) of an acquired view to the information matrix
+	void addObservation(const cv::Mat& J);
+
+	// expected information gain 0.5*log(det(Sigma)/det(Sigma_new)) of a view with measurement Jacobian J
+	double computeInformationGain(const cv::Mat& J) const;
+
+	// returns the index of the candidate with the best ratio of information gain and travel cost, -1 if no candidate adds information
+	// candidate_jacobians may contain empty matrices for candidates that are not expected to yield any measurement
+	int selectNextView(const std::vector<cv::Mat>& candidate_jacobians, const std::vector<double>& travel_costs, const double travel_cost_weight) const;
+
+	// true if the standard deviation of every parameter is below the respective entry of max_std
+	bool isConverged(const std::vector<double>& max_std) const;
+
+	std::vector<double> getStandardDeviations() const;
+	const cv::Mat& getCovariance() const;
+	int getParameterCount() const;
+
+
+protected:
+
+	// log(det(S)) of a symmetric positive definite matrix via Cholesky decomposition (S is overwritten with the factor),
+	// returns false if S is not positive definite
+	static bool computeLogDeterminant(cv::Mat& S, double& log_det);
+
+	cv::Mat prior_information_;		// inverse prior covariance (n x n)
+	cv::Mat information_;			// accumulated information matrix (n x n)
+	cv::Mat covariance_;			// inverse of information_, updated with every observation
+	double measurement_variance_;
+};
+
+
+#endif /* VIEW_SELECTION_H_ */
@@ -0,0 +1,243 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+#include <robotino_calibration/acquisition_checkpoint.h>
+#include <ros/ros.h>
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+// appends text with a single write call and syncs it to disk
+static bool appendToFile(const std::string& file_name, const std::string& text, const bool truncate)
+{
+	const int fd = open(file_name.c_str(), O_WRONLY | O_CREAT | (truncate ? O_TRUNC : O_APPEND), 0644);
+	if (fd < 0)
+		return false;
+
+	const bool success = (write(fd, text.c_str(), text.size()) == (ssize_t)text.size()) && (fsync(fd) == 0);
+	close(fd);
+	return success;
+}
+
+// 64 bit FNV-1a hash
+static uint64_t hashString(const std::string& text)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i=0; i<text.size(); ++i)
+	{
+		hash ^= (unsigned char)text[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+AcquisitionCheckpoint::AcquisitionCheckpoint(const std::string& file_name, const int number_configurations, const std::string& session_description) :
+		file_name_(file_name), number_configurations_(number_configurations), session_hash_(hashString(session_description)), captured_(number_configurations, false)
+{
+}
+
+std::string AcquisitionCheckpoint::describeSession(const std::string& marker_type, const std::vector<calibration_utilities::RobotConfiguration>& configurations)
+{
+	std::stringstream ss;
+	ss << std::setprecision(15) << marker_type << "\n";
+	for (size_t i=0; i<configurations.size(); ++i)
+		ss << configurations[i].pose_x_ << " " << configurations[i].pose_y_ << " " << configurations[i].pose_phi_ << " "
+				<< configurations[i].pan_angle_ << " " << configurations[i].tilt_angle_ << "\n";
+	return ss.str();
+}
+
+std::string AcquisitionCheckpoint::describeSession(const std::string& marker_type, const std::vector<calibration_utilities::AngleConfiguration>& arm_configurations,
+		const std::vector<calibration_utilities::AngleConfiguration>& camera_configurations)
+{
+	std::stringstream ss;
+	ss << std::setprecision(15) << marker_type << "\n";
+	for (size_t i=0; i<arm_configurations.size(); ++i)
+	{
+		for (size_t j=0; j<arm_configurations[i].angles_.size(); ++j)
+			ss << arm_configurations[i].angles_[j] << " ";
+		ss << "\n";
+	}
+	ss << "camera\n";
+	for (size_t i=0; i<camera_configurations.size(); ++i)
+	{
+		for (size_t j=0; j<camera_configurations[i].angles_.size(); ++j)
+			ss << camera_configurations[i].angles_[j] << " ";
+		ss << "\n";
+	}
+	return ss.str();
+}
+
+AcquisitionCheckpoint::~AcquisitionCheckpoint()
+{
+}
+
+bool AcquisitionCheckpoint::load()
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	captured_.assign(number_configurations_, false);
+
+	std::ifstream file(file_name_.c_str());
+	if (!file.is_open())
+		return false;
+
+	// the first line identifies the motion plan, e.g. "configurations 120 session 5f1c0e3a9b27d468"
+	std::string line;
+	int number_configurations = -1;
+	uint64_t session_hash = 0;
+	bool has_session_hash = false;
+	if (std::getline(file, line))
+	{
+		std::stringstream ss(line);
+		std::string key, session_key;
+		ss >> key >> number_configurations;
+		has_session_hash = (ss >> session_key >> std::hex >> session_hash) && session_key == "session";
+	}
+	if (number_configurations != number_configurations_)
+	{
+		ROS_WARN("AcquisitionCheckpoint::load: Checkpoint '%s' belongs to a session with %d instead of %d configurations.", file_name_.c_str(),
+				number_configurations, number_configurations_);
+		return false;
+	}
+	if (!has_session_hash || session_hash != session_hash_)
+	{
+		ROS_WARN("AcquisitionCheckpoint::load: Checkpoint '%s' belongs to a session with a different marker type or different configurations.", file_name_.c_str());
+		return false;
+	}
+
+	// one configuration index per line, an unterminated last line stems from an interrupted write and is ignored
+	while (std::getline(file, line))
+	{
+		if (file.eof())
+			break;
+
+		int index = -1;
+		std::stringstream ss(line);
+		if ((ss >> index) && index >= 0 && index < number_configurations_)
+			captured_[index] = true;
+	}
+
+	return true;
+}
+
+bool AcquisitionCheckpoint::clear()
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	captured_.assign(number_configurations_, false);
+
+	std::stringstream header;
+	header << "configurations " << number_configurations_ << " session " << std::hex << std::setw(16) << std::setfill('0') << session_hash_ << "\n";
+	if (!appendToFile(file_name_, header.str(), true))
+	{
+		ROS_WARN("AcquisitionCheckpoint::clear: Could not write checkpoint file '%s'.", file_name_.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool AcquisitionCheckpoint::markCaptured(const int configuration_index)
+{
+	if (configuration_index < 0 || configuration_index >= number_configurations_)
+		return false;
+
+	boost::mutex::scoped_lock lock(mutex_);
+	std::stringstream line;
+	line << configuration_index << "\n";
+	if (!appendToFile(file_name_, line.str(), false))
+	{
+		ROS_WARN("AcquisitionCheckpoint::markCaptured: Could not append to checkpoint file '%s'.", file_name_.c_str());
+		return false;
+	}
+
+	captured_[configuration_index] = true;
+	return true;
+}
+
+bool AcquisitionCheckpoint::isCaptured(const int configuration_index) const
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	return (configuration_index >= 0 && configuration_index < number_configurations_ && captured_[configuration_index]);
+}
+
+int AcquisitionCheckpoint::getCapturedCount() const
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	int count = 0;
+	for (size_t i=0; i<captured_.size(); ++i)
+		if (captured_[i])
+			++count;
+	return count;
+}
+
+bool AcquisitionCheckpoint::commitFile(const std::string& temp_file_name, const std::string& file_name)
+{
+	const int fd = open(temp_file_name.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	const bool synced = (fsync(fd) == 0);
+	close(fd);
+
+	if (!synced || std::rename(temp_file_name.c_str(), file_name.c_str()) != 0)
+	{
+		ROS_WARN("AcquisitionCheckpoint::commitFile: Could not move '%s' to '%s': %s", temp_file_name.c_str(), file_name.c_str(), strerror(errno));
+		return false;
+	}
+
+	return true;
+}
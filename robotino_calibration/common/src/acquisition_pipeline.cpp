@@ -0,0 +1,169 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+#include <robotino_calibration/acquisition_pipeline.h>
+#include <robotino_calibration/timer.h>
+#include <boost/bind.hpp>
+#include <iostream>
+#include <algorithm>
+
+
+AcquisitionPipeline::AcquisitionPipeline(const int number_workers, const int queue_capacity) :
+		queue_capacity_(std::max(1, queue_capacity)), active_jobs_(0), shutdown_(false), number_workers_(std::max(0, number_workers))
+{
+	for (int i=0; i<NUMBER_STAGES; ++i)
+	{
+		stage_count_[i] = 0;
+		stage_time_sum_[i] = 0.;
+		stage_time_max_[i] = 0.;
+	}
+
+	for (int i=0; i<number_workers_; ++i)
+		workers_.create_thread(boost::bind(&AcquisitionPipeline::workerLoop, this));
+}
+
+AcquisitionPipeline::~AcquisitionPipeline()
+{
+	{
+		boost::mutex::scoped_lock lock(mutex_);
+		shutdown_ = true;
+	}
+	queue_not_empty_.notify_all();
+	workers_.join_all();
+}
+
+void AcquisitionPipeline::enqueue(const boost::function<void()>& job)
+{
+	if (number_workers_ == 0)
+	{
+		runJob(job);
+		return;
+	}
+
+	Timer wait_time;
+	{
+		boost::mutex::scoped_lock lock(mutex_);
+		while ((int)queue_.size() >= queue_capacity_)
+			queue_not_full_.wait(lock);
+		queue_.push_back(job);
+	}
+	queue_not_empty_.notify_one();
+	addStageTime(STAGE_QUEUE_WAIT, wait_time.getElapsedTimeInSec());
+}
+
+void AcquisitionPipeline::waitUntilIdle()
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	while (!queue_.empty() || active_jobs_ > 0)
+		idle_.wait(lock);
+}
+
+void AcquisitionPipeline::workerLoop()
+{
+	while (true)
+	{
+		boost::function<void()> job;
+		{
+			boost::mutex::scoped_lock lock(mutex_);
+			while (queue_.empty() && !shutdown_)
+				queue_not_empty_.wait(lock);
+			if (queue_.empty())		// shutdown and nothing left to do
+				return;
+			job = queue_.front();
+			queue_.pop_front();
+			++active_jobs_;
+		}
+		queue_not_full_.notify_one();
+
+		runJob(job);
+
+		{
+			boost::mutex::scoped_lock lock(mutex_);
+			--active_jobs_;
+			if (queue_.empty() && active_jobs_ == 0)
+				idle_.notify_all();
+		}
+	}
+}
+
+void AcquisitionPipeline::runJob(const boost::function<void()>& job)
+{
+	Timer process_time;
+	job();
+	addStageTime(STAGE_PROCESS, process_time.getElapsedTimeInSec());
+}
+
+void AcquisitionPipeline::addStageTime(const Stage stage, const double seconds)
+{
+	boost::mutex::scoped_lock lock(statistics_mutex_);
+	++stage_count_[stage];
+	stage_time_sum_[stage] += seconds;
+	stage_time_max_[stage] = std::max(stage_time_max_[stage], seconds);
+}
+
+void AcquisitionPipeline::printStatistics()
+{
+	const char* stage_names[NUMBER_STAGES] = {"move", "capture", "queue wait", "process"};
+
+	boost::mutex::scoped_lock lock(statistics_mutex_);
+	std::cout << "Acquisition stage timing (" << number_workers_ << " worker threads):" << std::endl;
+	for (int i=0; i<NUMBER_STAGES; ++i)
+	{
+		std::cout << "  " << stage_names[i] << ": " << stage_count_[i] << " x, total " << stage_time_sum_[i] << "s, average "
+				<< (stage_count_[i]>0 ? stage_time_sum_[i]/stage_count_[i] : 0.) << "s, max " << stage_time_max_[i] << "s" << std::endl;
+	}
+}
+
+int AcquisitionPipeline::getNumberWorkers() const
+{
+	return number_workers_;
+}
@@ -0,0 +1,204 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/detection_cache.h>
+#include <ros/ros.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+
+static const char CACHE_MAGIC[8] = {'R','C','D','C','A','C','H','E'};
+
+struct CacheEntryHeader
+{
+	uint64_t key_;
+	int32_t number_corners_;	// -1 if the detection failed
+	uint32_t reserved_;
+};
+
+
+DetectionCache::DetectionCache() :
+		hits_(0), misses_(0)
+{
+}
+
+DetectionCache::~DetectionCache()
+{
+	if (file_.is_open())
+		file_.close();
+}
+
+bool DetectionCache::open(const std::string& file_name)
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	entries_.clear();
+	if (file_.is_open())
+		file_.close();
+
+	// read the existing entries and remember the end of the last complete one
+	std::streamoff valid_size = 0;
+	{
+		std::ifstream file(file_name.c_str(), std::ios::in | std::ios::binary);
+		char magic[sizeof(CACHE_MAGIC)];
+		if (file.read(magic, sizeof(magic)) && memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0)
+		{
+			valid_size = sizeof(CACHE_MAGIC);
+			CacheEntryHeader header;
+			while (file.read((char*)&header, sizeof(header)))
+			{
+				Entry entry;
+				entry.found_ = (header.number_corners_ >= 0);
+				entry.corners_.resize(std::max(0, header.number_corners_));
+				if (!entry.corners_.empty() && !file.read((char*)&entry.corners_[0], entry.corners_.size()*sizeof(cv::Point2f)))
+					break;
+				entries_[header.key_] = entry;
+				valid_size = file.tellg();
+			}
+		}
+	}
+
+	// start a new file if there is no valid cache file, otherwise cut off an incomplete entry at its end
+	if (valid_size == 0)
+	{
+		file_.open(file_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		file_.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	}
+	else
+	{
+		boost::system::error_code error;
+		boost::filesystem::resize_file(file_name, valid_size, error);
+		file_.open(file_name.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+	}
+	if (!file_.good())
+	{
+		ROS_WARN("DetectionCache::open: Could not open detection cache '%s', detections are not stored.", file_name.c_str());
+		file_.close();
+		return false;
+	}
+
+	std::cout << "Detection cache '" << file_name << "' contains " << entries_.size() << " entries." << std::endl;
+	return true;
+}
+
+uint64_t DetectionCache::hashData(const void* data, const size_t size, const uint64_t seed)
+{
+	uint64_t hash = seed;
+	const unsigned char* p = (const unsigned char*)data;
+	for (size_t i=0; i<size; ++i)
+	{
+		hash ^= p[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+uint64_t DetectionCache::hashImage(const cv::Mat& image)
+{
+	const int32_t header[3] = {image.rows, image.cols, image.type()};
+	uint64_t hash = hashData(header, sizeof(header));
+	const size_t row_bytes = image.cols*image.elemSize();
+	for (int v=0; v<image.rows; ++v)
+		hash = hashData(image.ptr(v), row_bytes, hash);
+	return hash;
+}
+
+uint64_t DetectionCache::computeKey(const uint64_t image_hash, const std::string& detector_settings)
+{
+	return hashData(detector_settings.c_str(), detector_settings.size(), image_hash);
+}
+
+bool DetectionCache::lookup(const uint64_t image_hash, const std::string& detector_settings, bool& found, std::vector<cv::Point2f>& corners)
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	std::map<uint64_t, Entry>::const_iterator it = entries_.find(computeKey(image_hash, detector_settings));
+	if (it == entries_.end())
+	{
+		++misses_;
+		return false;
+	}
+
+	++hits_;
+	found = it->second.found_;
+	corners = it->second.corners_;
+	return true;
+}
+
+void DetectionCache::insert(const uint64_t image_hash, const std::string& detector_settings, const bool found, const std::vector<cv::Point2f>& corners)
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	const uint64_t key = computeKey(image_hash, detector_settings);
+	Entry& entry = entries_[key];
+	entry.found_ = found;
+	entry.corners_ = (found ? corners : std::vector<cv::Point2f>());
+
+	if (!file_.is_open())
+		return;
+	CacheEntryHeader header;
+	header.key_ = key;
+	header.number_corners_ = (found ? (int32_t)entry.corners_.size() : -1);
+	header.reserved_ = 0;
+	file_.write((const char*)&header, sizeof(header));
+	if (!entry.corners_.empty())
+		file_.write((const char*)&entry.corners_[0], entry.corners_.size()*sizeof(cv::Point2f));
+	file_.flush();
+}
+
+void DetectionCache::printStatistics() const
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	std::cout << "Detection cache: " << hits_ << " hits, " << misses_ << " misses" << std::endl;
+}
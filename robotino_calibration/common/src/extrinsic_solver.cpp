@@ -0,0 +1,136 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/extrinsic_solver.h>
+#include <robotino_calibration/transformation_utilities.h>
+
+
+namespace extrinsic_solver
+{
+	cv::Mat estimateBaseToTorsoLower(const std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
+			const std::vector<cv::Mat>& T_base_to_marker_vector, const std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector,
+			const std::vector<cv::Mat>& T_camera_to_marker_vector, const cv::Mat& T_torso_upper_to_camera)
+	{
+		// transform 3d marker points to respective coordinates systems (base and torso_lower)
+		std::vector<cv::Point3d> points_3d_base, points_3d_torso_lower;
+		for (size_t i=0; i<pattern_points_3d.size(); ++i)
+		{
+			cv::Mat T_torso_lower_to_marker = T_torso_lower_to_torso_upper_vector[i] * T_torso_upper_to_camera * T_camera_to_marker_vector[i];
+			for (size_t j=0; j<pattern_points_3d[i].size(); ++j)
+			{
+				cv::Mat point = cv::Mat(cv::Vec4d(pattern_points_3d[i][j].x, pattern_points_3d[i][j].y, pattern_points_3d[i][j].z, 1.0));
+
+				// to base coordinate system
+				cv::Mat point_base = T_base_to_marker_vector[i] * point;
+				points_3d_base.push_back(cv::Point3d(point_base.at<double>(0), point_base.at<double>(1), point_base.at<double>(2)));
+
+				// to torso_lower coordinate
+				cv::Mat point_torso_lower = T_torso_lower_to_marker * point;
+				points_3d_torso_lower.push_back(cv::Point3d(point_torso_lower.at<double>(0), point_torso_lower.at<double>(1), point_torso_lower.at<double>(2)));
+			}
+		}
+
+		return transform_utilities::computeExtrinsicTransform(points_3d_base, points_3d_torso_lower);
+	}
+
+	cv::Mat estimateTorsoUpperToCamera(const std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
+			const std::vector<cv::Mat>& T_base_to_marker_vector, const std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector,
+			const std::vector<cv::Mat>& T_camera_to_marker_vector, const cv::Mat& T_base_to_torso_lower)
+	{
+		// transform 3d marker points to respective coordinates systems (camera and torso_upper)
+		const cv::Mat T_torso_lower_to_base = T_base_to_torso_lower.inv();
+		std::vector<cv::Point3d> points_3d_torso_upper, points_3d_camera;
+		for (size_t i=0; i<pattern_points_3d.size(); ++i)
+		{
+			cv::Mat T_torso_upper_to_marker = T_torso_lower_to_torso_upper_vector[i].inv() * T_torso_lower_to_base * T_base_to_marker_vector[i];
+			for (size_t j=0; j<pattern_points_3d[i].size(); ++j)
+			{
+				cv::Mat point = cv::Mat(cv::Vec4d(pattern_points_3d[i][j].x, pattern_points_3d[i][j].y, pattern_points_3d[i][j].z, 1.0));
+
+				// to camera coordinate system
+				cv::Mat point_camera = T_camera_to_marker_vector[i] * point;
+				points_3d_camera.push_back(cv::Point3d(point_camera.at<double>(0), point_camera.at<double>(1), point_camera.at<double>(2)));
+
+				// to torso_upper coordinate
+				cv::Mat point_torso_upper = T_torso_upper_to_marker * point;
+				points_3d_torso_upper.push_back(cv::Point3d(point_torso_upper.at<double>(0), point_torso_upper.at<double>(1), point_torso_upper.at<double>(2)));
+			}
+		}
+
+		return transform_utilities::computeExtrinsicTransform(points_3d_torso_upper, points_3d_camera);
+	}
+
+	cv::Mat estimateBaseToArmbase(const std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
+			const std::vector<cv::Mat>& T_base_to_checkerboard_vector, const std::vector<cv::Mat>& T_armbase_to_checkerboard_vector)
+	{
+		// transform 3d chessboard points to respective coordinates systems (base and arm base)
+		std::vector<cv::Point3d> points_3d_base, points_3d_armbase;
+		for (size_t i=0; i<pattern_points_3d.size(); ++i)
+		{
+			for (size_t j=0; j<pattern_points_3d[i].size(); ++j)
+			{
+				cv::Mat point = cv::Mat(cv::Vec4d(pattern_points_3d[i][j].x, pattern_points_3d[i][j].y, pattern_points_3d[i][j].z, 1.0));
+
+				// to base coordinate system
+				cv::Mat point_base = T_base_to_checkerboard_vector[i] * point; // from base to camera to checkerboard corners
+				points_3d_base.push_back(cv::Point3d(point_base.at<double>(0), point_base.at<double>(1), point_base.at<double>(2)));
+
+				// to armbase coordinate
+				cv::Mat point_armbase = T_armbase_to_checkerboard_vector[i] * point; // from arm base to checkerboard corners
+				points_3d_armbase.push_back(cv::Point3d(point_armbase.at<double>(0), point_armbase.at<double>(1), point_armbase.at<double>(2)));
+			}
+		}
+
+		return transform_utilities::computeExtrinsicTransform(points_3d_base, points_3d_armbase);
+	}
+}
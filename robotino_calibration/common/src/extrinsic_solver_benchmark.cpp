@@ -0,0 +1,253 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+// Offline benchmark of the extrinsic calibration solvers on synthetic datasets with known ground truth.
+// Reports wall time, heap allocations and the error w.r.t. ground truth for growing numbers of observations.
+// Heap allocations are counted on glibc only, as calls to malloc, calloc, realloc, memalign, posix_memalign and
+// aligned_alloc. This covers operator new and cv::Mat buffers (cv::fastMalloc uses one of these, depending on the OpenCV build).
+// Memory obtained by other means (valloc, mmap, custom allocators) is not counted.
+//
+// usage: extrinsic_solver_benchmark [max_observations=100000] [translation_noise=0.002] [outlier_rate=0.0] [iterations=10] [seed=42]
+
+#include <robotino_calibration/extrinsic_solver.h>
+#include <robotino_calibration/synthetic_observations.h>
+#include <robotino_calibration/transformation_utilities.h>
+
+#include <boost/chrono.hpp>
+#include <cerrno>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t number, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+#endif
+
+
+// heap allocation counters, operator new and cv::fastMalloc end up in one of the functions below
+static size_t g_allocation_count = 0;
+static size_t g_allocation_bytes = 0;
+
+#ifdef __GLIBC__
+extern "C" void* malloc(size_t size)
+{
+	++g_allocation_count;
+	g_allocation_bytes += size;
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t number, size_t size)
+{
+	++g_allocation_count;
+	g_allocation_bytes += number*size;
+	return __libc_calloc(number, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+	++g_allocation_count;
+	g_allocation_bytes += size;
+	return __libc_realloc(ptr, size);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size)
+{
+	++g_allocation_count;
+	g_allocation_bytes += size;
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+	// same argument check as glibc: a power of two multiple of sizeof(void*)
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment-1)) != 0 || alignment == 0)
+		return EINVAL;
+	++g_allocation_count;
+	g_allocation_bytes += size;
+	void* result = __libc_memalign(alignment, size);
+	if (result == 0)
+		return ENOMEM;
+	*ptr = result;
+	return 0;
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size)
+{
+	++g_allocation_count;
+	g_allocation_bytes += size;
+	return __libc_memalign(alignment, size);
+}
+#endif
+
+
+typedef boost::chrono::steady_clock Clock;
+
+struct Measurement
+{
+	Clock::time_point start_time_;
+	size_t allocation_count_;
+	size_t allocation_bytes_;
+
+	void start()
+	{
+		allocation_count_ = g_allocation_count;
+		allocation_bytes_ = g_allocation_bytes;
+		start_time_ = Clock::now();
+	}
+
+	// returns the elapsed time in s since start(), allocations are returned as difference
+	double stop(size_t& allocation_count, size_t& allocation_bytes) const
+	{
+		const double elapsed = boost::chrono::duration<double>(Clock::now() - start_time_).count();
+		allocation_count = g_allocation_count - allocation_count_;
+		allocation_bytes = g_allocation_bytes - allocation_bytes_;
+		return elapsed;
+	}
+};
+
+void benchmarkCameraBase(const int number_observations, const synthetic_observations::NoiseParameters& noise, const int iterations, cv::RNG& rng)
+{
+	synthetic_observations::CameraBaseDataset dataset;
+	synthetic_observations::generateCameraBaseDataset(number_observations, noise, rng, dataset);
+
+	// start from a perturbed ground truth, like the initial guess from the robot description
+	synthetic_observations::NoiseParameters initial_error;
+	initial_error.translation_sigma_ = 0.03;
+	initial_error.rotation_sigma_ = 0.1;
+	cv::Mat T_base_to_torso_lower = synthetic_observations::perturbTransform(dataset.T_base_to_torso_lower, rng, initial_error);
+	cv::Mat T_torso_upper_to_camera = synthetic_observations::perturbTransform(dataset.T_torso_upper_to_camera, rng, initial_error);
+
+	// alternating optimization as in the camera base calibration, errors are reported after 1, 10, 100, ... iterations
+	Measurement measurement;
+	double total_time = 0.;
+	size_t total_count = 0, total_bytes = 0;
+	int next_report = 1;
+	for (int i=1; i<=iterations; ++i)
+	{
+		size_t count = 0, bytes = 0;
+		measurement.start();
+		T_base_to_torso_lower = extrinsic_solver::estimateBaseToTorsoLower(dataset.pattern_points_3d, dataset.T_base_to_marker_vector,
+				dataset.T_torso_lower_to_torso_upper_vector, dataset.T_camera_to_marker_vector, T_torso_upper_to_camera);
+		T_torso_upper_to_camera = extrinsic_solver::estimateTorsoUpperToCamera(dataset.pattern_points_3d, dataset.T_base_to_marker_vector,
+				dataset.T_torso_lower_to_torso_upper_vector, dataset.T_camera_to_marker_vector, T_base_to_torso_lower);
+		total_time += measurement.stop(count, bytes);
+		total_count += count;
+		total_bytes += bytes;
+
+		if (i == next_report || i == iterations)
+		{
+			double rotation_error_lower = 0., translation_error_lower = 0., rotation_error_camera = 0., translation_error_camera = 0.;
+			synthetic_observations::computeTransformError(T_base_to_torso_lower, dataset.T_base_to_torso_lower, rotation_error_lower, translation_error_lower);
+			synthetic_observations::computeTransformError(T_torso_upper_to_camera, dataset.T_torso_upper_to_camera, rotation_error_camera, translation_error_camera);
+			std::cout << "camera_base  n=" << std::setw(6) << number_observations << "  iteration " << std::setw(5) << i
+					<< "  time/iteration " << std::setw(10) << total_time/i << "s  allocations/iteration " << std::setw(9) << total_count/i
+					<< " (" << total_bytes/i << " B)  base_to_torso_lower err " << rotation_error_lower << "deg " << translation_error_lower
+					<< "m  torso_upper_to_camera err " << rotation_error_camera << "deg " << translation_error_camera << "m" << std::endl;
+			if (i == next_report)
+				next_report *= 10;
+		}
+	}
+}
+
+void benchmarkArmBase(const int number_observations, const synthetic_observations::NoiseParameters& noise, cv::RNG& rng)
+{
+	synthetic_observations::ArmBaseDataset dataset;
+	synthetic_observations::generateArmBaseDataset(number_observations, noise, rng, dataset);
+
+	Measurement measurement;
+	size_t count = 0, bytes = 0;
+	measurement.start();
+	const cv::Mat T_base_to_armbase = extrinsic_solver::estimateBaseToArmbase(dataset.pattern_points_3d, dataset.T_base_to_checkerboard_vector,
+			dataset.T_armbase_to_checkerboard_vector);
+	const double time = measurement.stop(count, bytes);
+
+	double rotation_error = 0., translation_error = 0.;
+	synthetic_observations::computeTransformError(T_base_to_armbase, dataset.T_base_to_armbase, rotation_error, translation_error);
+	std::cout << "arm_base     n=" << std::setw(6) << number_observations << "  time " << std::setw(10) << time << "s  time/observation "
+			<< time/number_observations << "s  allocations " << count << " (" << bytes << " B)  base_to_armbase err " << rotation_error << "deg "
+			<< translation_error << "m" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	const int max_observations = (argc > 1 ? atoi(argv[1]) : 100000);
+	synthetic_observations::NoiseParameters noise;
+	noise.translation_sigma_ = (argc > 2 ? atof(argv[2]) : 0.002);
+	noise.rotation_sigma_ = 2.5*noise.translation_sigma_;	// 2 mm at 0.4 m lever arm ~ 5 mrad
+	noise.outlier_rate_ = (argc > 3 ? atof(argv[3]) : 0.);
+	const int iterations = (argc > 4 ? atoi(argv[4]) : 10);
+	const int seed = (argc > 5 ? atoi(argv[5]) : 42);
+
+	std::cout << "max_observations: " << max_observations << std::endl;
+	std::cout << "translation_noise: " << noise.translation_sigma_ << std::endl;
+	std::cout << "rotation_noise: " << noise.rotation_sigma_ << std::endl;
+	std::cout << "outlier_rate: " << noise.outlier_rate_ << std::endl;
+	std::cout << "iterations: " << iterations << std::endl;
+	std::cout << "seed: " << seed << std::endl;
+#ifndef __GLIBC__
+	std::cout << "allocation counting is only available with glibc, allocations are reported as 0." << std::endl;
+#endif
+
+	// scaling curve over 10, 100, ..., max_observations observations, every size uses the same seed for comparable datasets
+	for (int number_observations=10; number_observations<=max_observations; number_observations*=10)
+	{
+		cv::RNG rng(seed);
+		benchmarkArmBase(number_observations, noise, rng);
+		benchmarkCameraBase(number_observations, noise, iterations, rng);
+	}
+
+	return 0;
+}
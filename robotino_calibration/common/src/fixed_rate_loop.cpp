@@ -0,0 +1,122 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/fixed_rate_loop.h>
+
+#include <boost/thread/thread.hpp>
+#include <iostream>
+
+
+FixedRateLoop::FixedRateLoop(const double rate) :
+		period_(boost::chrono::duration_cast<Clock::duration>(boost::chrono::duration<double>(rate > 0. ? 1./rate : 0.05)))
+{
+	reset();
+}
+
+void FixedRateLoop::reset()
+{
+	next_wakeup_ = Clock::now() + period_;
+	cycle_count_ = 0;
+	overrun_count_ = 0;
+	jitter_sum_ = 0.;
+	jitter_max_ = 0.;
+}
+
+bool FixedRateLoop::sleep()
+{
+	++cycle_count_;
+
+	if (Clock::now() > next_wakeup_)
+	{
+		// the loop body took longer than one period, restart the schedule
+		++overrun_count_;
+		next_wakeup_ = Clock::now() + period_;
+		return false;
+	}
+
+	boost::this_thread::sleep_until(next_wakeup_);
+	const double jitter = boost::chrono::duration<double>(Clock::now() - next_wakeup_).count();
+	jitter_sum_ += jitter;
+	if (jitter > jitter_max_)
+		jitter_max_ = jitter;
+	next_wakeup_ += period_;
+
+	return true;
+}
+
+void FixedRateLoop::printStatistics(const std::string& name) const
+{
+	const int timed_cycles = cycle_count_ - overrun_count_;
+	std::cout << name << " loop timing (period " << getPeriod() << "s): " << cycle_count_ << " cycles, " << overrun_count_ << " overruns, jitter average "
+			<< (timed_cycles>0 ? jitter_sum_/timed_cycles : 0.) << "s, max " << jitter_max_ << "s" << std::endl;
+}
+
+int FixedRateLoop::getCycleCount() const
+{
+	return cycle_count_;
+}
+
+int FixedRateLoop::getOverrunCount() const
+{
+	return overrun_count_;
+}
+
+double FixedRateLoop::getMaxJitter() const
+{
+	return jitter_max_;
+}
+
+double FixedRateLoop::getPeriod() const
+{
+	return boost::chrono::duration<double>(period_).count();
+}
@@ -0,0 +1,374 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/session_archive.h>
+#include <ros/ros.h>
+
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <cerrno>
+#include <sstream>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+static const char ARCHIVE_MAGIC[8] = {'R','C','S','E','S','S','N','\0'};
+static const uint32_t ARCHIVE_VERSION = 1;
+static const uint32_t RECORD_MAGIC = 0x57454956;		// "VIEW"
+
+struct ArchiveHeader
+{
+	char magic_[8];
+	uint32_t version_;
+	uint32_t reserved_;
+};
+
+struct RecordHeader
+{
+	uint32_t magic_;
+	int32_t view_index_;
+	int32_t image_width_;
+	int32_t image_height_;
+	uint32_t number_transforms_;
+	uint32_t number_corners_;
+	uint32_t label_bytes_;
+	uint32_t image_bytes_;
+};
+
+static const size_t TRANSFORM_BYTES = 16*sizeof(double);
+static const size_t CORNER_BYTES = 2*sizeof(float);
+
+static size_t paddedSize(const size_t size)
+{
+	return (size + 7) & ~(size_t)7;
+}
+
+static size_t recordPayloadSize(const RecordHeader& header)
+{
+	return paddedSize(header.number_transforms_*TRANSFORM_BYTES + header.number_corners_*CORNER_BYTES + header.label_bytes_ + header.image_bytes_);
+}
+
+// writes data with a single write call and syncs it to disk
+static bool writeAndSync(const int file_descriptor, const std::vector<char>& data)
+{
+	return (::write(file_descriptor, &data[0], data.size()) == (ssize_t)data.size()) && (fsync(file_descriptor) == 0);
+}
+
+
+bool SessionArchiveRecord::encodeImage(const cv::Mat& image)
+{
+	image_size_ = image.size();
+	image_data_.clear();
+	return cv::imencode(".png", image, image_data_);
+}
+
+bool SessionArchiveRecord::encodeThumbnail(const cv::Mat& image, const double scale, const int jpeg_quality)
+{
+	image_size_ = image.size();
+	image_data_.clear();
+	if (scale <= 0.)
+		return true;
+
+	cv::Mat thumbnail;
+	cv::resize(image, thumbnail, cv::Size(), scale, scale, cv::INTER_AREA);
+	std::vector<int> parameters;
+	parameters.push_back(CV_IMWRITE_JPEG_QUALITY);
+	parameters.push_back(jpeg_quality);
+	return cv::imencode(".jpg", thumbnail, image_data_, parameters);
+}
+
+bool SessionArchiveRecord::decodeImage(cv::Mat& image, const int flags) const
+{
+	if (image_data_.empty())
+		return false;
+
+	image = cv::imdecode(image_data_, flags);
+	return !image.empty();
+}
+
+
+SessionArchiveWriter::SessionArchiveWriter() :
+		file_descriptor_(-1)
+{
+}
+
+SessionArchiveWriter::~SessionArchiveWriter()
+{
+	close();
+}
+
+bool SessionArchiveWriter::open(const std::string& file_name, const bool append)
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	if (file_descriptor_ >= 0)
+		::close(file_descriptor_);
+	file_name_ = file_name;
+
+	// cut off an incomplete record of an interrupted session, so new records are appended behind the last complete one
+	size_t valid_size = 0;
+	if (append)
+	{
+		SessionArchiveReader reader;
+		if (reader.open(file_name))
+			valid_size = reader.getValidSize();
+	}
+
+	file_descriptor_ = ::open(file_name.c_str(), O_WRONLY | O_CREAT, 0644);
+	if (file_descriptor_ < 0 || ftruncate(file_descriptor_, valid_size) != 0 || lseek(file_descriptor_, 0, SEEK_END) < 0)
+	{
+		ROS_WARN("SessionArchiveWriter::open: Could not open session archive '%s': %s", file_name.c_str(), strerror(errno));
+		if (file_descriptor_ >= 0)
+			::close(file_descriptor_);
+		file_descriptor_ = -1;
+		return false;
+	}
+
+	if (valid_size == 0)
+	{
+		ArchiveHeader header;
+		memcpy(header.magic_, ARCHIVE_MAGIC, sizeof(header.magic_));
+		header.version_ = ARCHIVE_VERSION;
+		header.reserved_ = 0;
+		std::vector<char> data((const char*)&header, (const char*)&header + sizeof(header));
+		if (!writeAndSync(file_descriptor_, data))
+		{
+			ROS_WARN("SessionArchiveWriter::open: Could not write session archive '%s'.", file_name.c_str());
+			::close(file_descriptor_);
+			file_descriptor_ = -1;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void SessionArchiveWriter::close()
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	if (file_descriptor_ >= 0)
+		::close(file_descriptor_);
+	file_descriptor_ = -1;
+}
+
+bool SessionArchiveWriter::write(const SessionArchiveRecord& record)
+{
+	std::stringstream labels;
+	for (size_t i=0; i<record.labels_.size(); ++i)
+		labels << (i>0 ? "\n" : "") << record.labels_[i];
+	const std::string label_string = labels.str();
+
+	RecordHeader header;
+	header.magic_ = RECORD_MAGIC;
+	header.view_index_ = record.view_index_;
+	header.image_width_ = record.image_size_.width;
+	header.image_height_ = record.image_size_.height;
+	header.number_transforms_ = record.transforms_.size();
+	header.number_corners_ = record.corners_.size();
+	header.label_bytes_ = label_string.size();
+	header.image_bytes_ = record.image_data_.size();
+
+	// serialize the complete record first, so it is written with one call
+	std::vector<char> data(sizeof(header) + recordPayloadSize(header), 0);
+	char* p = &data[0];
+	memcpy(p, &header, sizeof(header));
+	p += sizeof(header);
+	for (size_t i=0; i<record.transforms_.size(); ++i, p+=TRANSFORM_BYTES)
+	{
+		if (record.transforms_[i].empty())
+			continue;
+		cv::Mat T;
+		record.transforms_[i].convertTo(T, CV_64FC1);
+		if (T.rows != 4 || T.cols != 4)
+		{
+			ROS_WARN("SessionArchiveWriter::write: Transform %d of view %d is not a 4x4 matrix.", (int)i, record.view_index_);
+			return false;
+		}
+		for (int r=0; r<4; ++r)
+			memcpy(p + r*4*sizeof(double), T.ptr<double>(r), 4*sizeof(double));
+	}
+	if (!record.corners_.empty())
+		memcpy(p, &record.corners_[0], record.corners_.size()*CORNER_BYTES);
+	p += record.corners_.size()*CORNER_BYTES;
+	memcpy(p, label_string.c_str(), label_string.size());
+	p += label_string.size();
+	if (!record.image_data_.empty())
+		memcpy(p, &record.image_data_[0], record.image_data_.size());
+
+	boost::mutex::scoped_lock lock(mutex_);
+	if (file_descriptor_ < 0)
+		return false;
+	if (!writeAndSync(file_descriptor_, data))
+	{
+		ROS_WARN("SessionArchiveWriter::write: Could not append view %d to session archive '%s'.", record.view_index_, file_name_.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+
+SessionArchiveReader::SessionArchiveReader() :
+		valid_size_(0)
+{
+}
+
+bool SessionArchiveReader::open(const std::string& file_name)
+{
+	record_offsets_.clear();
+	valid_size_ = 0;
+
+	boost::system::error_code error;
+	const boost::uintmax_t file_size = boost::filesystem::file_size(file_name, error);
+	if (error || file_size < sizeof(ArchiveHeader))
+		return false;
+
+	try
+	{
+		boost::interprocess::file_mapping file(file_name.c_str(), boost::interprocess::read_only);
+		boost::interprocess::mapped_region region(file, boost::interprocess::read_only, 0, file_size);
+		file_.swap(file);
+		region_.swap(region);
+	}
+	catch (boost::interprocess::interprocess_exception& e)
+	{
+		ROS_WARN("SessionArchiveReader::open: Could not map session archive '%s': %s", file_name.c_str(), e.what());
+		return false;
+	}
+
+	const char* data = (const char*)region_.get_address();
+	ArchiveHeader archive_header;
+	memcpy(&archive_header, data, sizeof(archive_header));
+	if (memcmp(archive_header.magic_, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || archive_header.version_ != ARCHIVE_VERSION)
+	{
+		ROS_WARN("SessionArchiveReader::open: '%s' is no session archive of version %u.", file_name.c_str(), ARCHIVE_VERSION);
+		return false;
+	}
+
+	// index the records, stop at the first incomplete or damaged record
+	size_t offset = sizeof(ArchiveHeader);
+	while (offset + sizeof(RecordHeader) <= file_size)
+	{
+		RecordHeader header;
+		memcpy(&header, data + offset, sizeof(header));
+		const size_t record_size = sizeof(header) + recordPayloadSize(header);
+		if (header.magic_ != RECORD_MAGIC || offset + record_size > file_size)
+			break;
+
+		record_offsets_[header.view_index_] = offset;
+		offset += record_size;
+	}
+	valid_size_ = offset;
+	if (valid_size_ < file_size)
+		ROS_WARN("SessionArchiveReader::open: Ignoring %d bytes of incomplete data at the end of '%s'.", (int)(file_size-valid_size_), file_name.c_str());
+
+	return true;
+}
+
+bool SessionArchiveReader::hasView(const int view_index) const
+{
+	return record_offsets_.find(view_index) != record_offsets_.end();
+}
+
+bool SessionArchiveReader::read(const int view_index, SessionArchiveRecord& record, const bool load_image) const
+{
+	std::map<int, size_t>::const_iterator it = record_offsets_.find(view_index);
+	if (it == record_offsets_.end())
+		return false;
+
+	const char* p = (const char*)region_.get_address() + it->second;
+	RecordHeader header;
+	memcpy(&header, p, sizeof(header));
+	p += sizeof(header);
+
+	record.view_index_ = header.view_index_;
+	record.image_size_ = cv::Size(header.image_width_, header.image_height_);
+	record.transforms_.resize(header.number_transforms_);
+	for (size_t i=0; i<header.number_transforms_; ++i, p+=TRANSFORM_BYTES)
+	{
+		cv::Mat T(4, 4, CV_64FC1);
+		memcpy(T.ptr<double>(0), p, TRANSFORM_BYTES);
+		record.transforms_[i] = (T.at<double>(3,3) == 0. ? cv::Mat() : T);
+	}
+	record.corners_.resize(header.number_corners_);
+	if (header.number_corners_ > 0)
+		memcpy(&record.corners_[0], p, header.number_corners_*CORNER_BYTES);
+	p += header.number_corners_*CORNER_BYTES;
+
+	record.labels_.clear();
+	std::stringstream labels(std::string(p, header.label_bytes_));
+	std::string label;
+	while (std::getline(labels, label))
+		record.labels_.push_back(label);
+	p += header.label_bytes_;
+
+	if (load_image)
+		record.image_data_.assign((const uchar*)p, (const uchar*)p + header.image_bytes_);
+	else
+		record.image_data_.clear();
+
+	return true;
+}
+
+std::vector<int> SessionArchiveReader::getViewIndices() const
+{
+	std::vector<int> view_indices;
+	for (std::map<int, size_t>::const_iterator it = record_offsets_.begin(); it != record_offsets_.end(); ++it)
+		view_indices.push_back(it->first);
+	return view_indices;
+}
+
+size_t SessionArchiveReader::getValidSize() const
+{
+	return valid_size_;
+}
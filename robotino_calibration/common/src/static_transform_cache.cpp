@@ -0,0 +1,144 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/static_transform_cache.h>
+
+
+StaticTransformCache::StaticTransformCache(ros::NodeHandle nh, const tf::TransformListener& transform_listener) :
+		transform_listener_(transform_listener), stability_count_(3)
+{
+	tf_static_sub_ = nh.subscribe<tf::tfMessage>("/tf_static", 10, &StaticTransformCache::tfStaticCallback, this);
+}
+
+void StaticTransformCache::setStabilityCount(const int stability_count)
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	stability_count_ = stability_count;
+}
+
+bool StaticTransformCache::getTransform(const std::string& target_frame, const std::string& source_frame, const ros::Time& stamp,
+		const ros::Duration& timeout, cv::Mat& T)
+{
+	const transform_utilities::FramePair frame_pair(target_frame, source_frame);
+	{
+		boost::mutex::scoped_lock lock(mutex_);
+		std::map<transform_utilities::FramePair, CacheEntry>::const_iterator it = cache_.find(frame_pair);
+		if (it != cache_.end() && it->second.static_ == true)
+		{
+			T = it->second.T_.clone();
+			return true;
+		}
+	}
+
+	cv::Mat T_lookup;
+	if (transform_utilities::getTransform(transform_listener_, target_frame, source_frame, stamp, timeout, T_lookup) == false)
+		return false;
+	T = T_lookup;
+
+	// a zero latest common time means that the whole chain consists of /tf_static links
+	ros::Time latest_time;
+	const bool from_tf_static = (transform_listener_.getLatestCommonTime(target_frame, source_frame, latest_time, 0) == tf::NO_ERROR && latest_time.isZero());
+	const ros::Time lookup_stamp = (stamp.isZero() ? latest_time : stamp);
+
+	boost::mutex::scoped_lock lock(mutex_);
+	CacheEntry& entry = cache_[frame_pair];
+	if (entry.static_ == true)
+		return true;		// classified by a concurrent lookup
+	if (from_tf_static == true)
+	{
+		entry.static_ = true;
+	}
+	else if (entry.T_.empty() == false && isEqual(entry.T_, T_lookup) == true)
+	{
+		if (lookup_stamp != entry.stamp_)
+			++entry.stable_count_;
+		entry.static_ = (stability_count_ > 0 && entry.stable_count_ >= stability_count_);
+	}
+	else
+	{
+		entry.stable_count_ = 0;
+	}
+	entry.T_ = T_lookup.clone();
+	entry.stamp_ = lookup_stamp;
+	if (entry.static_ == true)
+		ROS_INFO("StaticTransformCache: transform from %s to %s is static and will be served from memory.", target_frame.c_str(), source_frame.c_str());
+
+	return true;
+}
+
+bool StaticTransformCache::isStatic(const std::string& target_frame, const std::string& source_frame) const
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	std::map<transform_utilities::FramePair, CacheEntry>::const_iterator it = cache_.find(transform_utilities::FramePair(target_frame, source_frame));
+	return (it != cache_.end() && it->second.static_ == true);
+}
+
+void StaticTransformCache::clear()
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	cache_.clear();
+}
+
+void StaticTransformCache::tfStaticCallback(const tf::tfMessage::ConstPtr& msg)
+{
+	// a publisher of static transforms has (re)started, the robot description may have changed
+	boost::mutex::scoped_lock lock(mutex_);
+	if (cache_.empty() == false)
+		ROS_INFO("StaticTransformCache: received new static transforms, clearing the cache.");
+	cache_.clear();
+}
+
+bool StaticTransformCache::isEqual(const cv::Mat& T1, const cv::Mat& T2)
+{
+	return (cv::norm(T1, T2, cv::NORM_INF) < 1e-6);
+}
@@ -0,0 +1,173 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/synthetic_observations.h>
+#include <robotino_calibration/transformation_utilities.h>
+#include <robotino_calibration/calibration_utilities.h>
+
+
+namespace synthetic_observations
+{
+	namespace
+	{
+		cv::Mat rotationFromAxisAngle(cv::RNG& rng, const double angle)
+		{
+			cv::Vec3d axis(rng.gaussian(1.), rng.gaussian(1.), rng.gaussian(1.));
+			const double norm = cv::norm(axis);
+			if (norm < 1e-9)
+				axis = cv::Vec3d(0., 0., 1.);
+			else
+				axis *= 1./norm;
+
+			cv::Mat R;
+			cv::Rodrigues(cv::Mat(axis*angle), R);
+			return R;
+		}
+
+		cv::Mat rotationZ(const double angle)
+		{
+			return (cv::Mat_<double>(3,3) << cos(angle), -sin(angle), 0., sin(angle), cos(angle), 0., 0., 0., 1.);
+		}
+
+		cv::Mat rotationY(const double angle)
+		{
+			return (cv::Mat_<double>(3,3) << cos(angle), 0., sin(angle), 0., 1., 0., -sin(angle), 0., cos(angle));
+		}
+	}
+
+	cv::Mat randomRotation(cv::RNG& rng, const double sigma)
+	{
+		return rotationFromAxisAngle(rng, rng.gaussian(sigma));
+	}
+
+	cv::Mat randomRotationUniform(cv::RNG& rng, const double max_angle)
+	{
+		return rotationFromAxisAngle(rng, rng.uniform(-max_angle, max_angle));
+	}
+
+	cv::Mat perturbTransform(const cv::Mat& T, cv::RNG& rng, const NoiseParameters& noise)
+	{
+		cv::Mat R, t;
+		if (rng.uniform(0., 1.) < noise.outlier_rate_)
+		{
+			R = randomRotationUniform(rng, noise.outlier_rotation_);
+			t = cv::Mat(cv::Vec3d(rng.uniform(-noise.outlier_translation_, noise.outlier_translation_),
+					rng.uniform(-noise.outlier_translation_, noise.outlier_translation_), rng.uniform(-noise.outlier_translation_, noise.outlier_translation_)));
+		}
+		else
+		{
+			R = randomRotation(rng, noise.rotation_sigma_);
+			t = cv::Mat(cv::Vec3d(rng.gaussian(noise.translation_sigma_), rng.gaussian(noise.translation_sigma_), rng.gaussian(noise.translation_sigma_)));
+		}
+		return T * transform_utilities::makeTransform(R, t);
+	}
+
+	void generateCameraBaseDataset(const int number_observations, const NoiseParameters& noise, cv::RNG& rng, CameraBaseDataset& dataset)
+	{
+		// typical mounting: torso on top of the base, camera with optical axis pointing forwards
+		const cv::Mat R_upper_to_optical = (cv::Mat_<double>(3,3) << 0., 0., 1., -1., 0., 0., 0., -1., 0.);
+		dataset.T_base_to_torso_lower = transform_utilities::makeTransform(randomRotationUniform(rng, 0.05), cv::Mat(cv::Vec3d(0.25, 0., 0.65)));
+		dataset.T_torso_upper_to_camera = transform_utilities::makeTransform(randomRotationUniform(rng, 0.05)*R_upper_to_optical, cv::Mat(cv::Vec3d(0.05, 0., 0.1)));
+
+		// 4 marker corners of a 0.1 m square tag
+		const float half_size = 0.05f;
+		std::vector<cv::Point3f> marker_points;
+		marker_points.push_back(cv::Point3f(-half_size, -half_size, 0.f));
+		marker_points.push_back(cv::Point3f(half_size, -half_size, 0.f));
+		marker_points.push_back(cv::Point3f(half_size, half_size, 0.f));
+		marker_points.push_back(cv::Point3f(-half_size, half_size, 0.f));
+
+		dataset.pattern_points_3d.assign(number_observations, marker_points);
+		dataset.T_base_to_marker_vector.resize(number_observations);
+		dataset.T_torso_lower_to_torso_upper_vector.resize(number_observations);
+		dataset.T_camera_to_marker_vector.resize(number_observations);
+		for (int i=0; i<number_observations; ++i)
+		{
+			const double pan = rng.uniform(-0.8, 0.8);
+			const double tilt = rng.uniform(-0.4, 0.4);
+			dataset.T_torso_lower_to_torso_upper_vector[i] = transform_utilities::makeTransform(rotationZ(pan)*rotationY(tilt), cv::Mat(cv::Vec3d(0., 0., 0.1)));
+
+			// marker roughly facing the camera (marker z axis points away from the camera)
+			const cv::Mat T_camera_to_marker = transform_utilities::makeTransform(randomRotationUniform(rng, 0.4),
+					cv::Mat(cv::Vec3d(rng.uniform(-0.3, 0.3), rng.uniform(-0.2, 0.2), rng.uniform(1.0, 2.0))));
+			dataset.T_base_to_marker_vector[i] = dataset.T_base_to_torso_lower * dataset.T_torso_lower_to_torso_upper_vector[i] * dataset.T_torso_upper_to_camera * T_camera_to_marker;
+			dataset.T_camera_to_marker_vector[i] = perturbTransform(T_camera_to_marker, rng, noise);
+		}
+	}
+
+	void generateArmBaseDataset(const int number_observations, const NoiseParameters& noise, cv::RNG& rng, ArmBaseDataset& dataset)
+	{
+		dataset.T_base_to_armbase = transform_utilities::makeTransform(randomRotationUniform(rng, 0.05), cv::Mat(cv::Vec3d(0.1, 0.2, 0.4)));
+
+		// 6x4 checkerboard with 3 cm cells as used by the arm calibration
+		calibration_utilities::computeCheckerboard3dPoints(dataset.pattern_points_3d, cv::Size(6,4), 0.03, number_observations);
+
+		dataset.T_base_to_checkerboard_vector.resize(number_observations);
+		dataset.T_armbase_to_checkerboard_vector.resize(number_observations);
+		for (int i=0; i<number_observations; ++i)
+		{
+			dataset.T_armbase_to_checkerboard_vector[i] = transform_utilities::makeTransform(randomRotationUniform(rng, 0.5),
+					cv::Mat(cv::Vec3d(rng.uniform(0.3, 0.6), rng.uniform(-0.3, 0.3), rng.uniform(0.2, 0.6))));
+			dataset.T_base_to_checkerboard_vector[i] = perturbTransform(dataset.T_base_to_armbase * dataset.T_armbase_to_checkerboard_vector[i], rng, noise);
+		}
+	}
+
+	void computeTransformError(const cv::Mat& T_estimate, const cv::Mat& T_truth, double& rotation_error, double& translation_error)
+	{
+		const cv::Mat T_delta = T_truth.inv() * T_estimate;
+		cv::Mat rvec;
+		cv::Rodrigues(T_delta(cv::Rect(0,0,3,3)), rvec);
+		rotation_error = cv::norm(rvec) * 180. / CV_PI;
+		translation_error = cv::norm(T_estimate(cv::Rect(3,0,1,3)) - T_truth(cv::Rect(3,0,1,3)));
+	}
+}
@@ -57,6 +57,7 @@
 #include <tf/exceptions.h>
 
 #include <string>
+#include <algorithm>
 #include <ros/ros.h>
 
 namespace transform_utilities
@@ -168,28 +169,84 @@ namespace transform_utilities
 		}
 	}*/
 
+	// converts a tf transform into a 4x4 transformation matrix
+	cv::Mat transformToMat(const tf::Transform& transform)
+	{
+		const tf::Matrix3x3& rot = transform.getBasis();
+		const tf::Vector3& trans = transform.getOrigin();
+		cv::Mat rotcv(3,3,CV_64FC1);
+		cv::Mat transcv(3,1,CV_64FC1);
+		for (int v=0; v<3; ++v)
+			for (int u=0; u<3; ++u)
+				rotcv.at<double>(v,u) = rot[v].m_floats[u];
+		for (int v=0; v<3; ++v)
+			transcv.at<double>(v) = trans.m_floats[v];
+		return makeTransform(rotcv, transcv);
+	}
+
 	// computes the transform from target_frame to source_frame (i.e. transform arrow is pointing from target_frame to source_frame)
 	bool getTransform(const tf::TransformListener& transform_listener, const std::string& target_frame, const std::string& source_frame, cv::Mat& T)
 	{
+		return getTransform(transform_listener, target_frame, source_frame, ros::Time(0), ros::Duration(1.0), T);
+	}
+
+	bool getTransform(const tf::TransformListener& transform_listener, const std::string& target_frame, const std::string& source_frame,
+			const ros::Time& stamp, const ros::Duration& timeout, cv::Mat& T)
+	{
+		std::vector<FramePair> frame_pairs(1, FramePair(target_frame, source_frame));
+		std::vector<cv::Mat> transforms;
+		if (getTransforms(transform_listener, frame_pairs, stamp, timeout, transforms) == false)
+			return false;
+
+		T = transforms[0];
+		return true;
+	}
+
+	bool getTransforms(const tf::TransformListener& transform_listener, const std::vector<FramePair>& frame_pairs, const ros::Time& stamp,
+			const ros::Duration& timeout, std::vector<cv::Mat>& transforms)
+	{
+		transforms.clear();
 		try
 		{
-			tf::StampedTransform Ts;
-			transform_listener.waitForTransform(target_frame, source_frame, ros::Time(0), ros::Duration(1.0));
-			transform_listener.lookupTransform(target_frame, source_frame, ros::Time(0), Ts);
-			const tf::Matrix3x3& rot = Ts.getBasis();
-			const tf::Vector3& trans = Ts.getOrigin();
-			cv::Mat rotcv(3,3,CV_64FC1);
-			cv::Mat transcv(3,1,CV_64FC1);
-			for (int v=0; v<3; ++v)
-				for (int u=0; u<3; ++u)
-					rotcv.at<double>(v,u) = rot[v].m_floats[u];
-			for (int v=0; v<3; ++v)
-				transcv.at<double>(v) = trans.m_floats[v];
-			T = makeTransform(rotcv, transcv);
+			// all frame pairs share the wait budget
+			const ros::Time deadline = ros::Time::now() + timeout;
+			ros::Time query_time = stamp;
+			for (size_t i=0; i<frame_pairs.size(); ++i)
+			{
+				const ros::Duration remaining = std::max(ros::Duration(0.), deadline - ros::Time::now());
+				if (stamp.isZero())
+				{
+					// latest data: wait until the pair is available at all, then query all pairs at their latest common instant
+					transform_listener.waitForTransform(frame_pairs[i].first, frame_pairs[i].second, ros::Time(0), remaining);
+					ros::Time latest_time;
+					std::string error;
+					if (transform_listener.getLatestCommonTime(frame_pairs[i].first, frame_pairs[i].second, latest_time, &error) != tf::NO_ERROR)
+					{
+						ROS_WARN("%s", error.c_str());
+						return false;
+					}
+					if (i==0 || (!latest_time.isZero() && (query_time.isZero() || latest_time < query_time)))		// zero = static transform, valid at any time
+						query_time = latest_time;
+				}
+				else if (transform_listener.waitForTransform(frame_pairs[i].first, frame_pairs[i].second, stamp, remaining) == false)
+				{
+					ROS_WARN("Transform from %s to %s is not available at %f within %f s.", frame_pairs[i].first.c_str(), frame_pairs[i].second.c_str(),
+							stamp.toSec(), timeout.toSec());
+					return false;
+				}
+			}
+
+			for (size_t i=0; i<frame_pairs.size(); ++i)
+			{
+				tf::StampedTransform Ts;
+				transform_listener.lookupTransform(frame_pairs[i].first, frame_pairs[i].second, query_time, Ts);
+				transforms.push_back(transformToMat(Ts));
+			}
 		}
 		catch (tf::TransformException& ex)
 		{
 			ROS_WARN("%s",ex.what());
+			transforms.clear();
 			return false;
 		}
 
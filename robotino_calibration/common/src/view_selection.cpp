@@ -0,0 +1,182 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+#include <robotino_calibration/view_selection.h>
+#include <cmath>
+#include <algorithm>
+
+
+ViewSelection::ViewSelection(const std::vector<double>& prior_std, const double measurement_std) :
+		measurement_variance_(measurement_std*measurement_std)
+{
+	prior_information_ = cv::Mat::zeros((int)prior_std.size(), (int)prior_std.size(), CV_64F);
+	for (size_t i=0; i<prior_std.size(); ++i)
+		prior_information_.at<double>(i,i) = 1.0/(prior_std[i]*prior_std[i]);
+
+	if ( measurement_variance_ <= 0. )
+		measurement_variance_ = 1.;
+
+	reset();
+}
+
+ViewSelection::~ViewSelection()
+{
+}
+
+void ViewSelection::reset()
+{
+	information_ = prior_information_.clone();
+	covariance_ = information_.inv(cv::DECOMP_CHOLESKY);
+}
+
+void ViewSelection::addObservation(const cv::Mat& J)
+{
+	if ( J.empty() || J.cols != information_.cols )
+		return;
+
+	information_ += J.t() * J / measurement_variance_;
+	covariance_ = information_.inv(cv::DECOMP_CHOLESKY);
+}
+
+double ViewSelection::computeInformationGain(const cv::Mat& J) const
+{
+	if ( J.empty() || J.cols != covariance_.cols )
+		return 0.;
+
+	// determinant lemma: det(Sigma)/det(Sigma_new) = det(I + J*Sigma*J^T/sigma^2), only m x m instead of n x n
+	// the determinant itself overflows for weak priors or many measurements, so log(det) is summed from the Cholesky factor
+	cv::Mat S = cv::Mat::eye(J.rows, J.rows, CV_64F) + J * covariance_ * J.t() / measurement_variance_;
+	double log_det = 0.;
+	if ( !computeLogDeterminant(S, log_det) || log_det <= 0. )
+		return 0.;
+
+	return 0.5*log_det;
+}
+
+bool ViewSelection::computeLogDeterminant(cv::Mat& S, double& log_det)
+{
+	// in-place Cholesky decomposition S = L*L^T (lower triangle), log(det(S)) = 2*sum(log(L_ii))
+	log_det = 0.;
+	const int m = S.rows;
+	for (int j=0; j<m; ++j)
+	{
+		double* row_j = S.ptr<double>(j);
+		double d = row_j[j];
+		for (int k=0; k<j; ++k)
+			d -= row_j[k]*row_j[k];
+		if ( !(d > 0.) )
+			return false;
+		const double l_jj = std::sqrt(d);
+		row_j[j] = l_jj;
+		log_det += 2.*std::log(l_jj);
+
+		for (int i=j+1; i<m; ++i)
+		{
+			double* row_i = S.ptr<double>(i);
+			double s = row_i[j];
+			for (int k=0; k<j; ++k)
+				s -= row_i[k]*row_j[k];
+			row_i[j] = s/l_jj;
+		}
+	}
+	return true;
+}
+
+int ViewSelection::selectNextView(const std::vector<cv::Mat>& candidate_jacobians, const std::vector<double>& travel_costs, const double travel_cost_weight) const
+{
+	int best_index = -1;
+	double best_score = 0.;
+	for (size_t i=0; i<candidate_jacobians.size(); ++i)
+	{
+		const double gain = computeInformationGain(candidate_jacobians[i]);
+		const double cost = (i<travel_costs.size() ? travel_costs[i] : 0.);
+		const double score = gain / (1. + travel_cost_weight*cost);
+		if ( score > best_score )
+		{
+			best_score = score;
+			best_index = (int)i;
+		}
+	}
+
+	return best_index;
+}
+
+bool ViewSelection::isConverged(const std::vector<double>& max_std) const
+{
+	const std::vector<double> std_dev = getStandardDeviations();
+	if ( max_std.size() != std_dev.size() )
+		return false;
+
+	for (size_t i=0; i<std_dev.size(); ++i)
+		if ( std_dev[i] > max_std[i] )
+			return false;
+
+	return true;
+}
+
+std::vector<double> ViewSelection::getStandardDeviations() const
+{
+	std::vector<double> std_dev(covariance_.rows);
+	for (int i=0; i<covariance_.rows; ++i)
+		std_dev[i] = std::sqrt(std::max(0., covariance_.at<double>(i,i)));
+	return std_dev;
+}
+
+const cv::Mat& ViewSelection::getCovariance() const
+{
+	return covariance_;
+}
+
+int ViewSelection::getParameterCount() const
+{
+	return information_.rows;
+}
@@ -76,6 +76,7 @@
 
 #include <robotino_calibration/calibration_utilities.h>
 #include <robotino_calibration/robot_calibration.h>
+#include <robotino_calibration/detection_cache.h>
 
 
 class ArmBaseCalibration : public RobotCalibration
@@ -98,11 +99,45 @@ protected:
 	void extrinsicCalibrationBaseToArm(std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
 			std::vector<cv::Mat>& T_base_to_checkerboard_vector, std::vector<cv::Mat>& T_armbase_to_refframe_vector);
 
+	// image, detected checkerboard points and transforms captured at one arm configuration
+	struct ArmView
+	{
+		cv::Mat image_;		// color image as captured, empty if loaded from disk
+		cv::Mat gray_;		// empty if the view was replayed from stored corners
+		cv::Size image_size_;
+		std::vector<cv::Point2f> checkerboard_points_2d_;
+		cv::Mat T_armbase_to_checkerboard_;
+		cv::Mat T_base_to_camera_optical_;
+		bool valid_;		// true if the checkerboard was found and the view is complete
+
+		ArmView() : valid_(false) {}
+	};
+
 	bool acquireCalibrationImages(const cv::Size pattern_size, const bool load_images, int& image_width, int& image_height,
 			std::vector< std::vector<cv::Point2f> >& points_2d_per_image, std::vector<cv::Mat>& T_armbase_to_refframe_vector,
 			std::vector<cv::Mat>& T_base_to_camera_optical_vector);
-	int acquireCalibrationImage(int& image_width, int& image_height,
-			std::vector<cv::Point2f>& checkerboard_points_2d, const cv::Size pattern_size, const bool load_images, int& image_counter);
+
+	// waits for the camera to settle and takes the latest camera image and its time stamp, returns 0 on success
+	int captureImage(cv::Mat& image, ros::Time& stamp);
+
+	// loads transforms and checkerboard corners of a view from the session archive, sessions recorded as per-view image and yml files are read from these files
+	// the stored corners are used if they were detected with the current detector settings, otherwise the detection is taken from detection_cache
+	// and the image is only decoded and the checkerboard detected again if the cache has no entry for this image and these settings
+	bool loadView(const SessionArchiveReader& archive, DetectionCache& detection_cache, const int image_counter, const cv::Size pattern_size, ArmView& view);
+
+	// processing stage of the acquisition pipeline: detects the checkerboard, appends the view to the archive and records it in the checkpoint,
+	// releases the image data of the view afterwards
+	void processView(const int image_counter, const cv::Size pattern_size, ArmView& view, SessionArchiveWriter& archive, AcquisitionCheckpoint& checkpoint);
+
+	// appends the processed view to the session archive, successful detections are recorded in the checkpoint
+	void saveView(const int image_counter, const cv::Size pattern_size, const bool pattern_found, ArmView& view, SessionArchiveWriter& archive,
+			AcquisitionCheckpoint& checkpoint);
+
+	// identifies the checkerboard detector and its settings, stored with the detected corners
+	std::string getDetectorSettings(const cv::Size pattern_size) const;
+
+	// detects the checkerboard points in view.gray_
+	bool detectCheckerboard(ArmView& view, const cv::Size pattern_size);
 
 	void imageCallback(const sensor_msgs::ImageConstPtr& color_image_msg);
 
@@ -57,6 +57,8 @@
 #include <std_msgs/Float64.h>
 #include <geometry_msgs/Twist.h>
 
+#include <robotino_calibration/joint_state_buffer.h>
+
 class CalibrationInterface
 {
 protected:
@@ -75,11 +77,11 @@ public:
 	// camera calibration interface
 	virtual void assignNewRobotVelocity(geometry_msgs::Twist newVelocity) = 0;
 	virtual void assignNewCameraAngles(std_msgs::Float64MultiArray newAngles) = 0;
-	virtual std::vector<double>* getCurrentCameraState() = 0;
+	virtual JointStateSnapshot getCurrentCameraState() = 0;	// returns a copy of the latest camera joint state, never blocks the joint state callbacks
 
 	// arm calibration interface
 	virtual void assignNewArmJoints(std_msgs::Float64MultiArray newJointConfig) = 0;
-	virtual std::vector<double>* getCurrentArmState() = 0;
+	virtual JointStateSnapshot getCurrentArmState() = 0;	// returns a copy of the latest arm joint state, never blocks the joint state callbacks
 };
 
 
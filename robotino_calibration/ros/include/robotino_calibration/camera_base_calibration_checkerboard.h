@@ -53,6 +53,7 @@
 
 
 #include <robotino_calibration/camera_base_calibration_marker.h>
+#include <robotino_calibration/detection_cache.h>
 
 
 class CameraBaseCalibrationCheckerboard : public CameraBaseCalibrationMarker
@@ -77,6 +78,20 @@ protected:
 
 	void imageCallback(const sensor_msgs::ImageConstPtr& color_image_msg);
 
+	// image, detected checkerboard points and transforms captured at one robot configuration
+	struct CheckerboardView
+	{
+		cv::Mat image_;		// empty if the view was replayed from stored corners
+		cv::Size image_size_;
+		std::vector<cv::Point2f> checkerboard_points_2d_;
+		cv::Mat T_base_to_checkerboard_;
+		cv::Mat T_torso_lower_to_torso_upper_;
+		cv::Mat T_camera_to_camera_optical_;
+		bool valid_;		// true if the checkerboard was found and the view is complete
+
+		CheckerboardView() : valid_(false) {}
+	};
+
 	// acquires images automatically from all set up robot configurations and detects the checkerboard points
 	// @param load_images loads calibration images and transformations from hard disk if set to true (images and transformations are stored automatically during recording from a real camera)
 	// retrieves the image size, checkerboard points per image as well as all relevant transformations
@@ -85,9 +100,27 @@ protected:
 			std::vector<cv::Mat>& T_base_to_checkerboard_vector, std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector,
 			std::vector<cv::Mat>& T_camera_to_camera_optical_vector);
 
-	// acquire a single image and detect checkerboard points
-	int acquireCalibrationImage(int& image_width, int& image_height, std::vector<cv::Point2f>& points_2d_per_image,
-			const cv::Size pattern_size, const bool load_images, int& image_counter);
+	// waits for the camera to settle and takes the latest camera image and its time stamp, returns 0 on success
+	int captureImage(cv::Mat& image, ros::Time& stamp);
+
+	// loads transforms and checkerboard corners of a view from the session archive, sessions recorded as per-view image and yml files are read from these files
+	// the stored corners are used if they were detected with the current detector settings, otherwise the detection is taken from detection_cache
+	// and the image is only decoded and the checkerboard detected again if the cache has no entry for this image and these settings
+	bool loadView(const SessionArchiveReader& archive, DetectionCache& detection_cache, const int image_counter, const cv::Size pattern_size, CheckerboardView& view);
+
+	// processing stage of the acquisition pipeline: detects the checkerboard, appends the view to the archive and records it in the checkpoint,
+	// releases the image data of the view afterwards
+	void processView(const int image_counter, const cv::Size pattern_size, CheckerboardView& view, SessionArchiveWriter& archive, AcquisitionCheckpoint& checkpoint);
+
+	// appends the processed view to the session archive, successful detections are recorded in the checkpoint
+	void saveView(const int image_counter, const cv::Size pattern_size, const bool pattern_found, CheckerboardView& view, SessionArchiveWriter& archive,
+			AcquisitionCheckpoint& checkpoint);
+
+	// identifies the checkerboard detector and its settings, stored with the detected corners
+	std::string getDetectorSettings(const cv::Size pattern_size) const;
+
+	// detects the checkerboard points in view.image_, display must only be set from the main thread
+	bool detectCheckerboard(CheckerboardView& view, const cv::Size pattern_size, const bool display);
 
 	// intrinsic camera calibration (+ distortion coefficients)
 	void intrinsicCalibration(const std::vector< std::vector<cv::Point3f> >& pattern_points, const std::vector< std::vector<cv::Point2f> >& camera_points_2d_per_image, const cv::Size& image_size, std::vector<cv::Mat>& rvecs_jai, std::vector<cv::Mat>& tvecs_jai);
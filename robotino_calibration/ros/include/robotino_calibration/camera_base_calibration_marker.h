@@ -58,6 +58,7 @@
 #include <sensor_msgs/Image.h>
 #include <std_msgs/Float64MultiArray.h>
 #include <geometry_msgs/Twist.h>
+#include <geometry_msgs/PoseWithCovarianceStamped.h>
 
 // image transport
 #include <image_transport/image_transport.h>
@@ -79,6 +80,11 @@
 
 #include <robotino_calibration/timer.h>
 #include <robotino_calibration/robot_calibration.h>
+#include <robotino_calibration/reference_pose_feed.h>
+#include <robotino_calibration/seqlock_slot.h>
+#include <robotino_calibration/fixed_rate_loop.h>
+
+#include <boost/atomic.hpp>
 
 #define RefFrameHistorySize 10 // 10 entries used to build the average upon
 
@@ -105,11 +111,20 @@ protected:
 	// moves the robot to a desired location and adjusts the torso joints
 	bool moveRobot(const calibration_utilities::RobotConfiguration& robot_configuration);
 
+	// base positioning of moveRobot, executed on a dedicated control thread at base_control_rate_
+	void controlBasePose(const calibration_utilities::RobotConfiguration& robot_configuration, bool& success);
+
 	// Turn off base movement
 	void turnOffBaseMotion();
 
 	bool isReferenceFrameValid(cv::Mat &T); // Returns wether reference frame is valid -> if so, it is save to move the robot base, otherwise stop!
 
+	// watchdog callback of reference_pose_feed_, stops the base if it is moving while the reference frame is outdated
+	void stopBaseOnStalePose();
+
+	// stores the planar covariance of the reference frame published by the relative localization
+	void referencePoseCovarianceCallback(const geometry_msgs::PoseWithCovarianceStamped::ConstPtr& msg);
+
 	void extrinsicCalibrationBaseToTorsoLower(std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
 			std::vector<cv::Mat>& T_base_to_checkerboard_vector, std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector,
 			std::vector<cv::Mat>& T_camera_to_checkerboard_vector);
@@ -137,6 +152,20 @@ protected:
 	std::vector<calibration_utilities::RobotConfiguration> robot_configurations_;  // wished robot configurations used for calibration
 	double RefFrameHistory_[RefFrameHistorySize]; // History of base_frame to reference_frame squared lengths, used to get average squared length. Holds last <RefFrameHistorySize> measurements.
 	int RefHistoryIndex_; // Current index of history building
+	ReferencePoseFeed* reference_pose_feed_;	// latest pose of base_frame_ in child_frame_name_, updated in the background
+	ros::Subscriber reference_pose_covariance_sub_;
+	struct ReferencePoseCovariance
+	{
+		double variance_x_;		// [m^2]
+		double variance_y_;		// [m^2]
+		double variance_yaw_;	// [rad^2]
+		ros::Time stamp_;		// scan time of the localization estimate
+	};
+	SeqlockSlot<ReferencePoseCovariance> reference_pose_covariance_;	// uncertainty of the reference frame, written by the covariance subscriber
+	double max_reference_position_stddev_;	// [m] the reference frame is considered unreliable above this position standard deviation
+	double max_reference_angle_stddev_;		// [rad] the reference frame is considered unreliable above this angle standard deviation
+	boost::atomic<bool> base_in_motion_;	// true while velocity commands are sent to the base
+	double base_control_rate_;	// [Hz] rate of the base position controller
 };
 
 
@@ -53,6 +53,10 @@
 
 
 #include <robotino_calibration/camera_base_calibration_marker.h>
+#include <robotino_calibration/view_selection.h>
+#include <robotino_calibration/pitag_detector.h>
+#include <cob_object_detection_msgs/DetectionArray.h>
+#include <map>
 
 
 class CameraBaseCalibrationPiTag : public CameraBaseCalibrationMarker
@@ -74,6 +78,25 @@ public:
 
 protected:
 
+	// markers and transforms captured at one robot configuration, stored as one record of the session archive
+	struct PiTagView
+	{
+		std::vector<std::string> marker_frames_;
+		std::vector<cv::Mat> T_base_to_marker_vector_;
+		std::vector<cv::Mat> T_torso_lower_to_torso_upper_vector_;
+		std::vector<cv::Mat> T_camera_to_marker_vector_;
+		cv::Mat T_reference_to_base_;		// robot pose in the reference frame at capture time, empty if not available
+		cv::Mat T_camera_to_camera_optical_;
+	};
+
+	// appends/reads a single view to/from the session archive
+	// transforms are stored as T_reference_to_base, T_camera_to_camera_optical followed by the three transforms of each marker, labels are the marker frames
+	bool saveView(SessionArchiveWriter& archive, const int configuration_index, const PiTagView& view);
+	bool loadView(const SessionArchiveReader& archive, const int configuration_index, PiTagView& view);
+
+	// processing stage of the acquisition pipeline: saves the view and records it in the checkpoint
+	void processView(const int configuration_index, const PiTagView view, SessionArchiveWriter& archive, AcquisitionCheckpoint& checkpoint);
+
 	// acquires images automatically from all set up robot configurations and detects the checkerboard points
 	// @param load_images loads calibration images and transformations from hard disk if set to true (images and transformations are stored automatically during recording from a real camera)
 	// retrieves the image size, checkerboard points per image as well as all relevant transformations
@@ -85,9 +108,43 @@ protected:
 			const bool load_data, std::vector<cv::Mat>& T_base_to_marker_vector,
 			std::vector< std::vector<cv::Mat> >& T_between_gaps_vector, std::vector<cv::Mat>& T_camera_to_marker_vector); // New version, more flexible
 
+	// active view selection: picks the not yet visited robot configuration with the best ratio of expected uncertainty reduction and travel cost
+	// the observations of a candidate are predicted from the marker positions seen so far and the torso pose of the closest visited camera configuration
+	// returns -1 if all configurations have been visited
+	int selectNextConfiguration(const std::vector<calibration_utilities::RobotConfiguration>& robot_configurations, const std::vector<bool>& visited,
+			const int last_index, const ViewSelection& view_selection, const std::vector<cv::Mat>& T_torso_lower_to_torso_upper_per_configuration,
+			const std::map<std::string, cv::Mat>& marker_points_reference, const cv::Mat& T_reference_to_base_last, const cv::Mat& T_camera_to_camera_optical);
+
+	// refines the view selection estimates of both transforms with the markers captured so far and re-linearizes the covariance of view_selection at the new estimate
+	void updateViewSelection(ViewSelection& view_selection, std::vector<cv::Mat>& T_base_to_marker_vector,
+			std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector, std::vector<cv::Mat>& T_camera_to_marker_vector);
+
+	// 3x12 Jacobian of a marker point (in base coordinates) w.r.t. small rotations and translations (wx, wy, wz, x, y, z)
+	// of view_selection_T_base_to_torso_lower_ (applied in base frame) and view_selection_T_torso_upper_to_camera_ (applied in torso_upper frame)
+	cv::Mat computeMarkerJacobian(const cv::Mat& T_torso_lower_to_torso_upper, const cv::Mat& point_base) const;
+
+	// detects the Pi tags visible in the current camera image, either in-process or with the cob_fiducials service, returns false if no tag was found
+	bool detectMarkers(cob_object_detection_msgs::DetectionArray& detection_array);
+
 	ros::ServiceClient pitag_client_;
+	PiTagDetector* pitag_detector_;		// in-process Pi tag detection, 0 if the cob_fiducials service is used
+	bool pitag_in_process_detection_;	// detect Pi tags within this node instead of calling get_fiducials_topic_
+	int pitag_detection_passes_;		// number of camera images evaluated per view with in-process detection
 	std::string marker_frame_base_name_;
 	std::string get_fiducials_topic_;
+
+	bool active_view_selection_;		// if true, robot configurations are visited in the order of their expected information gain until the uncertainty thresholds are met
+	double view_selection_max_std_rotation_;		// [rad] acquisition stops once the rotational standard deviations of both transforms fall below
+	double view_selection_max_std_translation_;		// [m] acquisition stops once the translational standard deviations of both transforms fall below
+	double view_selection_prior_std_rotation_;		// [rad] uncertainty of the initial rotation estimates
+	double view_selection_prior_std_translation_;	// [m] uncertainty of the initial translation estimates
+	double view_selection_measurement_std_;		// [m] uncertainty of a single marker position measurement
+	double view_selection_travel_cost_weight_;		// weight of the travel cost (m, rad) relative to the information gain
+	double view_selection_field_of_view_;		// [rad] half opening angle of the camera used to predict visible markers
+	int view_selection_min_views_;		// minimum number of visited configurations before stopping early
+	int view_selection_optimization_iterations_;	// alternating optimization iterations per captured view for the view selection estimates
+	cv::Mat view_selection_T_base_to_torso_lower_;		// running estimates of the view selection, the calibrated transforms are only estimated after the acquisition
+	cv::Mat view_selection_T_torso_upper_to_camera_;
 };
 
 #endif // __CAMERA_BASE_CALIBRATION_PITAG_H__
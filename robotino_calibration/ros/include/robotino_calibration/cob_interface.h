@@ -53,7 +53,7 @@
 
 #include <robotino_calibration/calibration_interface.h>
 #include <sensor_msgs/JointState.h>
-#include <boost/thread/mutex.hpp>
+#include <robotino_calibration/joint_state_demultiplexer.h>
 
 class CobInterface : public CalibrationInterface
 {
@@ -63,12 +63,19 @@ protected:
 	std::string arm_right_command_;
 	std::string arm_right_state_topic_;
 	std::string base_velocity_command_;
+	std::string arm_to_calibrate_;		// arm whose joint state is reported by getCurrentArmState(), "left" or "right"
 	ros::Subscriber arm_left_state_;
 	ros::Subscriber arm_right_state_;
 	ros::Publisher arm_left_controller_;
 	ros::Publisher arm_right_controller_;
 	ros::Publisher base_velocity_controller_;
 
+	JointStateBuffer camera_state_current_;		// latest camera joint state
+	JointStateBuffer arm_left_state_current_;	// latest left arm joint state, written by armLeftStateCallback
+	JointStateBuffer arm_right_state_current_;	// latest right arm joint state, written by armRightStateCallback
+	JointStateDemultiplexer arm_left_state_demux_;	// extracts arm_left_joint_names from the joint state messages, forwards all if empty
+	JointStateDemultiplexer arm_right_state_demux_;	// extracts arm_right_joint_names from the joint state messages, forwards all if empty
+
 public:
 	CobInterface(ros::NodeHandle nh, bool bArmCalibration);
 	~CobInterface();
@@ -79,7 +86,7 @@ public:
 	// camera calibration interface
 	void assignNewRobotVelocity(geometry_msgs::Twist newVelocity);
 	void assignNewCameraAngles(std_msgs::Float64MultiArray newAngles);
-	std::vector<double>* getCurrentCameraState();
+	JointStateSnapshot getCurrentCameraState();
 
 	// callbacks
 	void cameraStateCallback(const sensor_msgs::JointState::ConstPtr& msg);
@@ -88,7 +95,7 @@ public:
 
 	// arm calibration interface
 	void assignNewArmJoints(std_msgs::Float64MultiArray newJointConfig);
-	std::vector<double>* getCurrentArmState();
+	JointStateSnapshot getCurrentArmState();
 };
 
 #endif /* COB_INTERFACE_H_ */
@@ -0,0 +1,103 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef JOINT_STATE_BUFFER_H_
+#define JOINT_STATE_BUFFER_H_
+
+#include <ros/ros.h>
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
+
+// a copy of the latest joint state of a robot part, returned by value from the calibration interfaces
+struct JointStateSnapshot
+{
+	std::vector<double> positions_;	// joint positions in the order of the configured joints
+	ros::Time stamp_;				// time stamp of the joint state message, ros::Time(0) if no message has been received yet
+};
+
+// Holds the latest joint state of one joint state topic.
+// Single writer (the subscriber callback), any number of readers. Implemented as a sequence lock:
+// the writer never waits and never allocates, readers copy the data and retry if a write happened in between.
+class JointStateBuffer
+{
+public:
+
+	// capacity = maximum number of joint positions that can be stored, the memory is allocated once here
+	// initial_size = number of joint positions (all 0.) that are reported before the first message arrives
+	JointStateBuffer(const size_t capacity=32, const size_t initial_size=0);
+	~JointStateBuffer();
+
+	// increases the capacity to at least capacity (keeps the stored joint state),
+	// reallocates, so it must only be called before the buffer is shared with the subscriber callback
+	void reserve(const size_t capacity);
+
+	// stores a new joint state, only call from one thread at a time (i.e. from the subscriber callback)
+	// positions exceeding the capacity are dropped with a warning
+	void write(const std::vector<double>& positions, const ros::Time& stamp);
+
+	// returns a consistent copy of the latest joint state, never blocks the writer
+	JointStateSnapshot read() const;
+
+	size_t capacity() const;
+
+protected:
+
+	boost::scoped_array< boost::atomic<double> > positions_;
+	size_t capacity_;
+	boost::atomic<size_t> size_;
+	boost::atomic<uint64_t> stamp_nsec_;
+	boost::atomic<unsigned int> sequence_;		// odd while a write is in progress
+};
+
+
+#endif /* JOINT_STATE_BUFFER_H_ */
@@ -0,0 +1,112 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef JOINT_STATE_DEMULTIPLEXER_H_
+#define JOINT_STATE_DEMULTIPLEXER_H_
+
+#include <sensor_msgs/JointState.h>
+#include <robotino_calibration/joint_state_buffer.h>
+#include <string>
+#include <vector>
+
+// Extracts the positions of a configured set of joints from joint state messages, e.g. from a merged /joint_states topic.
+// The indices of the joints inside a message are resolved once per message layout (name list) and cached, so the messages
+// of several publishers on one topic each keep their own index table. A regular message costs k string comparisons and a gather of k values.
+// A message may contain only a part of the configured joints (e.g. pan and tilt joint published in separate messages):
+// the contained joints are updated, the others keep their last value (0. until they have been received once).
+// If no joint names are configured, all positions of the message are forwarded in message order.
+class JointStateDemultiplexer
+{
+public:
+
+	JointStateDemultiplexer(const std::vector<std::string>& joint_names);
+	~JointStateDemultiplexer();
+
+	// sets a new list of joint names, clears the cached index tables
+	void setJointNames(const std::vector<std::string>& joint_names);
+	const std::vector<std::string>& getJointNames() const;
+
+	// writes the configured joints contained in msg to buffer, the other joints keep their last value
+	// returns false (and leaves buffer untouched) if msg does not contain any of the configured joints
+	bool update(const sensor_msgs::JointState& msg, JointStateBuffer& buffer);
+
+protected:
+
+	// index table of one message layout, identified by the size and the first entry of the name list
+	struct IndexTable
+	{
+		size_t name_count_;
+		std::string first_name_;
+		std::vector<size_t> indices_;	// indices_[j] = index of joint_names_[j] in the message, NOT_CONTAINED if the layout lacks this joint
+		size_t contained_joints_;		// number of configured joints contained in the layout
+		std::vector<std::string> names_;	// complete name list, only stored if the layout contains none of the configured joints
+	};
+
+	static const size_t NOT_CONTAINED;
+	static const size_t MAX_CACHED_LAYOUTS;		// the oldest index table is dropped if more layouts appear
+
+	// returns the cached index table matching the layout of msg, NULL if there is none
+	const IndexTable* findIndexTable(const sensor_msgs::JointState& msg) const;
+
+	// checks whether table matches the name list of msg (layout key and the names at the indices of the contained joints,
+	// the complete name list for tables without contained joints, so that a different layout with the same key is resolved)
+	bool isIndexTableValid(const IndexTable& table, const sensor_msgs::JointState& msg) const;
+
+	// resolves all joint names to indices in msg and caches the table, replacing an outdated table with the same layout key
+	const IndexTable& resolveIndexTable(const sensor_msgs::JointState& msg);
+
+	std::vector<std::string> joint_names_;	// configured joint names, defines the order of the gathered positions
+	std::vector<IndexTable> index_tables_;	// one index table per message layout seen so far
+	std::vector<double> positions_;			// preallocated gather buffer, holds the last value of every configured joint
+};
+
+
+#endif /* JOINT_STATE_DEMULTIPLEXER_H_ */
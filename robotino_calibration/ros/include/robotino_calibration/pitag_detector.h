@@ -0,0 +1,123 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef PITAG_DETECTOR_H_
+#define PITAG_DETECTOR_H_
+
+#include <ros/ros.h>
+#include <ros/callback_queue.h>
+#include <sensor_msgs/Image.h>
+#include <sensor_msgs/CameraInfo.h>
+#include <cob_object_detection_msgs/DetectionArray.h>
+#include <cob_fiducials/pi/FiducialModelPi.h>
+#include <opencv2/opencv.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <deque>
+#include <string>
+
+
+// Detects Pi tags in-process on the camera stream instead of calling the service of a separate cob_fiducials node.
+// Images and camera info are received on a dedicated callback queue and the detection runs on its own worker thread,
+// which always processes the newest image and drops older ones. Images are only processed while a detect() call
+// still needs images taken after its request time, otherwise the worker thread is idle. The results have the same format as the
+// DetectObjects service response, so the acquisition code can use both sources interchangeably.
+class PiTagDetector
+{
+public:
+
+	// model_file: Pi tag configuration file (e.g. piTagIni_0.xml)
+	PiTagDetector(ros::NodeHandle nh, const std::string& camera_image_topic, const std::string& camera_info_topic, const std::string& model_file);
+	~PiTagDetector();
+
+	// collects the detections of number_passes images that were taken at or after request_time, tags seen in several images are
+	// reported with their latest detection, waits at most timeout, returns false if the images could not be processed in time
+	// or if the detector could not be initialized
+	bool detect(const ros::Time& request_time, const int number_passes, const ros::Duration& timeout, cob_object_detection_msgs::DetectionArray& detections);
+
+
+protected:
+
+	void imageCallback(const sensor_msgs::ImageConstPtr& image_msg);
+	void cameraInfoCallback(const sensor_msgs::CameraInfoConstPtr& camera_info_msg);
+
+	// worker thread: runs the detector on the newest image
+	void detectionThread();
+
+	// converts the detector output into the message format of cob_fiducials
+	void convertDetections(const std::vector<ipa_Fiducials::t_pose>& tags, const std_msgs::Header& header, cob_object_detection_msgs::DetectionArray& detections) const;
+
+	std::string model_file_;
+	ros::CallbackQueue callback_queue_;		// image and camera info callbacks are served independent of the main thread
+	ros::AsyncSpinner* spinner_;
+	ros::Subscriber image_sub_;
+	ros::Subscriber camera_info_sub_;
+
+	boost::shared_ptr<ipa_Fiducials::FiducialModelPi> pi_tag_;
+	boost::thread detection_thread_;
+	boost::mutex mutex_;		// secures all members below
+	boost::condition_variable image_available_;
+	boost::condition_variable detections_available_;
+	cv::Mat camera_matrix_;		// projection matrix from camera info, empty until received
+	sensor_msgs::ImageConstPtr pending_image_;		// newest image that has not been processed yet
+	std::deque<cob_object_detection_msgs::DetectionArray> results_;		// detections of the recently processed images
+	ros::Time pending_request_time_;	// request time of the running detect() call, older images are not processed
+	size_t pending_passes_;		// number of images detect() still waits for, 0 = no request pending
+	bool initialization_failed_;		// the detector could not be initialized (e.g. invalid model file), detect() fails immediately
+	bool shutdown_;
+};
+
+
+#endif /* PITAG_DETECTOR_H_ */
@@ -53,7 +53,7 @@
 
 #include <robotino_calibration/calibration_interface.h>
 #include <sensor_msgs/JointState.h>
-#include <boost/thread/mutex.hpp>
+#include <robotino_calibration/joint_state_demultiplexer.h>
 
 class RAWInterface : public CalibrationInterface
 {
@@ -67,8 +67,8 @@ protected:
 
 	//double pan_joint_state_current_;
 	//double tilt_joint_state_current_;
-	std::vector<double> camera_state_current_;
-	boost::mutex pan_tilt_joint_state_data_mutex_;	// secures read operations on pan tilt joint state data
+	JointStateBuffer camera_state_current_;		// latest torso joint state, written by cameraStateCallback
+	JointStateDemultiplexer camera_state_demux_;	// extracts the torso joints (camera_joint_names) from the joint state messages
 	std::string joint_state_topic_;
 
 	std::string camera_joint_state_topic_;
@@ -76,8 +76,8 @@ protected:
 
 	std::string arm_state_topic_;
 	ros::Subscriber arm_state_;
-	sensor_msgs::JointState* arm_state_current_;
-	boost::mutex arm_state_data_mutex_;	// secures read operations on pan tilt joint state data
+	JointStateBuffer arm_state_current_;		// latest arm joint state, written by armStateCallback
+	JointStateDemultiplexer arm_state_demux_;	// extracts the arm joints (arm_joint_names) from the joint state messages
 
 
 public:
@@ -89,7 +89,7 @@ public:
 	// camera calibration interface
 	void assignNewRobotVelocity(geometry_msgs::Twist new_velocity);
 	void assignNewCameraAngles(std_msgs::Float64MultiArray new_angles);
-	std::vector<double>* getCurrentCameraState();
+	JointStateSnapshot getCurrentCameraState();
 
 	// callbacks
 	void cameraStateCallback(const sensor_msgs::JointState::ConstPtr& msg);
@@ -97,7 +97,7 @@ public:
 
 	// arm calibration interface
 	void assignNewArmJoints(std_msgs::Float64MultiArray new_joint_config);
-	std::vector<double>* getCurrentArmState();
+	JointStateSnapshot getCurrentArmState();
 };
 
 
@@ -0,0 +1,120 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef REFERENCE_POSE_FEED_H_
+#define REFERENCE_POSE_FEED_H_
+
+#include <ros/ros.h>
+#include <tf/transform_listener.h>
+#include <opencv2/opencv.hpp>
+#include <robotino_calibration/seqlock_slot.h>
+
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <string>
+
+
+// Keeps the latest transform from target_frame to source_frame (e.g. reference frame to robot base) available for control loops.
+// A background thread polls TF without waiting and writes the pose into a lock-free slot, so readers never block on TF.
+// The thread also acts as a watchdog: when the pose has not been updated for longer than max_age, the stale callback is
+// invoked once (e.g. to stop the robot base) until fresh data arrives again.
+class ReferencePoseFeed
+{
+public:
+
+	ReferencePoseFeed(const tf::TransformListener& transform_listener, const std::string& target_frame, const std::string& source_frame,
+			const double update_rate, const ros::Duration& max_age);
+	~ReferencePoseFeed();
+
+	// callback invoked from the feed thread when the pose becomes stale, set before start()
+	void setStaleCallback(const boost::function<void ()>& stale_callback);
+
+	void start();
+	void stop();
+
+	// returns the latest pose as 4x4 transform and its age, never blocks, returns false if no pose has been received yet
+	bool getLatestPose(cv::Mat& T, ros::Duration& age) const;
+
+	// returns true if a pose younger than max_age is available
+	bool isFresh() const;
+
+	const ros::Duration& getMaxAge() const;
+
+
+protected:
+
+	// polls TF at update_rate_ and runs the watchdog
+	void feedThread();
+
+	const tf::TransformListener& transform_listener_;
+	std::string target_frame_;
+	std::string source_frame_;
+	double update_rate_;		// [Hz]
+	ros::Duration max_age_;
+	boost::function<void ()> stale_callback_;
+
+	// the 4x4 transform in row-major order, stamped with the TF time
+	struct StampedPose
+	{
+		double T_[16];
+		ros::Time stamp_;
+	};
+
+	SeqlockSlot<StampedPose> pose_buffer_;
+	boost::thread feed_thread_;
+	boost::atomic<bool> running_;
+};
+
+
+#endif /* REFERENCE_POSE_FEED_H_ */
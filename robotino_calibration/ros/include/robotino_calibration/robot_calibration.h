@@ -56,6 +56,10 @@
 #include <tf/transform_listener.h>
 #include <robotino_calibration/calibration_utilities.h>
 #include <robotino_calibration/calibration_interface.h>
+#include <robotino_calibration/acquisition_checkpoint.h>
+#include <robotino_calibration/acquisition_pipeline.h>
+#include <robotino_calibration/session_archive.h>
+#include <robotino_calibration/static_transform_cache.h>
 #include <opencv2/opencv.hpp>
 #include <cv_bridge/cv_bridge.h>
 
@@ -83,12 +87,27 @@ protected:
 
 	void createStorageFolder();
 
+	// continues the session recorded in checkpoint if resume_acquisition_ is set and the checkpoint matches the motion plan, otherwise starts a new session
+	void startAcquisitionSession(AcquisitionCheckpoint& checkpoint);
+
+	// stores the camera image of a view in record according to image_storage_mode_: the full image in mode "full" or if the pattern
+	// was not found, otherwise only a thumbnail
+	bool storeViewImage(const cv::Mat& image, const bool pattern_found, SessionArchiveRecord& record) const;
+
 	int calibration_ID_;		// ID for identifying which calibration interface to use.
 	bool calibrated_;
 	tf::TransformListener transform_listener_;
 	ros::NodeHandle node_handle_;
 	std::string base_frame_;
 	std::string calibration_storage_path_;  // path to data
+	bool resume_acquisition_;	// skip the configurations captured by an interrupted session and continue its motion plan
+	int acquisition_worker_threads_;	// number of threads processing captured views while the robot moves on, 0 processes every view before moving on
+	int acquisition_queue_size_;	// maximum number of captured views waiting for processing
+	std::string image_storage_mode_;	// "full": views are stored with their full image, "corners": corners, transforms and a thumbnail, full images only for failed detections
+	double thumbnail_scale_;	// scale of the stored thumbnails in mode "corners", 0 stores no thumbnail
+	int thumbnail_jpeg_quality_;	// jpeg quality [0,100] of the stored thumbnails
+	ros::Duration transform_lookup_timeout_;	// maximum time to wait for the transforms of one view
+	StaticTransformCache static_transform_cache_;	// serves frame pairs that are fixed by the robot description from memory
 	std::string child_frame_name_;  // name of reference frame
 	CalibrationInterface *calibration_interface_;
 	std::vector<CalibrationInfo> transforms_to_calibrate_;
@@ -53,7 +53,7 @@
 
 #include <robotino_calibration/calibration_interface.h>
 #include <sensor_msgs/JointState.h>
-#include <boost/thread/mutex.hpp>
+#include <robotino_calibration/joint_state_demultiplexer.h>
 
 class RobotinoInterface : public CalibrationInterface
 {
@@ -69,15 +69,15 @@ protected:
 
 	ros::Subscriber camera_joint_state_sub_;
 	std::string camera_joint_state_topic_;			// topic name of the topic which contains current camera joint states
-	std::vector<double> camera_state_current_;
-	boost::mutex camera_joint_state_data_mutex_;	// secures read operations on camera joint state data
+	JointStateBuffer camera_state_current_;		// latest pan/tilt joint state, written by cameraJointStateCallback
+	JointStateDemultiplexer camera_state_demux_;	// extracts pan and tilt joint from the joint state messages
 	std::string pan_joint_name_;			// name of the pan joint in array of tilt_joint_states_topic_ topic
 	std::string tilt_joint_name_;			// name of the tilt joint in array of tilt_joint_states_topic_ topic
 
 	ros::Subscriber arm_state_;
 	std::string arm_state_topic_;
-	sensor_msgs::JointState* arm_state_current_;
-	boost::mutex arm_state_data_mutex_;	// secures read operations on pan tilt joint state data
+	JointStateBuffer arm_state_current_;		// latest arm joint state, written by armStateCallback
+	JointStateDemultiplexer arm_state_demux_;	// extracts the arm joints (arm_joint_names) from the joint state messages, forwards all if empty
 
 public:
 	RobotinoInterface(ros::NodeHandle nh, bool do_arm_calibration);
@@ -89,7 +89,7 @@ public:
 	// camera calibration interface
 	void assignNewRobotVelocity(geometry_msgs::Twist new_velocity);
 	void assignNewCameraAngles(std_msgs::Float64MultiArray new_angles);
-	std::vector<double>* getCurrentCameraState();
+	JointStateSnapshot getCurrentCameraState();
 
 	// callbacks
 	void cameraJointStateCallback(const sensor_msgs::JointState::ConstPtr& msg);
@@ -97,7 +97,7 @@ public:
 
 	// arm calibration interface
 	void assignNewArmJoints(std_msgs::Float64MultiArray new_joint_config);
-	std::vector<double>* getCurrentArmState();
+	JointStateSnapshot getCurrentArmState();
 };
 
 
@@ -0,0 +1,128 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+#ifndef SEQLOCK_SLOT_H_
+#define SEQLOCK_SLOT_H_
+
+#include <cstring>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+
+// Holds the latest value of a small, trivially copyable type T (plain numbers and ros::Time members only).
+// Single writer, any number of readers. Implemented as a sequence lock like the JointStateBuffer:
+// the writer never waits, readers copy the value word by word and retry if a write happened in between.
+template <typename T>
+class SeqlockSlot
+{
+public:
+
+	SeqlockSlot() :
+		sequence_(0)
+	{
+		for (size_t i=0; i<number_words_; ++i)
+			words_[i].store(0, boost::memory_order_relaxed);
+	}
+
+	// stores a new value, only call from one thread at a time
+	void write(const T& value)
+	{
+		boost::uint64_t buffer[number_words_] = {0};
+		std::memcpy(buffer, &value, sizeof(T));
+
+		// mark write in progress
+		const unsigned int sequence = sequence_.load(boost::memory_order_relaxed);
+		sequence_.store(sequence+1, boost::memory_order_relaxed);
+		boost::atomic_thread_fence(boost::memory_order_release);
+
+		for (size_t i=0; i<number_words_; ++i)
+			words_[i].store(buffer[i], boost::memory_order_relaxed);
+
+		// publish
+		sequence_.store(sequence+2, boost::memory_order_release);
+	}
+
+	// copies the latest value into value, never blocks the writer, returns false if no value has been written yet
+	bool read(T& value) const
+	{
+		boost::uint64_t buffer[number_words_];
+
+		while (true)
+		{
+			const unsigned int sequence_before = sequence_.load(boost::memory_order_acquire);
+			if (sequence_before == 0)
+				return false;
+			if ((sequence_before & 1) == 0)
+			{
+				for (size_t i=0; i<number_words_; ++i)
+					buffer[i] = words_[i].load(boost::memory_order_relaxed);
+
+				boost::atomic_thread_fence(boost::memory_order_acquire);
+				if (sequence_.load(boost::memory_order_relaxed) == sequence_before)	// no write in between -> copy is consistent
+				{
+					std::memcpy(&value, buffer, sizeof(T));
+					return true;
+				}
+			}
+		}
+	}
+
+protected:
+
+	static const size_t number_words_ = (sizeof(T)+sizeof(boost::uint64_t)-1)/sizeof(boost::uint64_t);
+
+	boost::atomic<boost::uint64_t> words_[number_words_];
+	boost::atomic<unsigned int> sequence_;		// odd while a write is in progress, 0 if nothing has been written yet
+};
+
+
+#endif /* SEQLOCK_SLOT_H_ */
@@ -0,0 +1,186 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#ifndef SIMULATION_INTERFACE_H_
+#define SIMULATION_INTERFACE_H_
+
+#include <robotino_calibration/calibration_interface.h>
+#include <ros/callback_queue.h>
+#include <sensor_msgs/JointState.h>
+#include <sensor_msgs/CameraInfo.h>
+#include <image_transport/image_transport.h>
+#include <tf/transform_listener.h>
+#include <tf/transform_broadcaster.h>
+#include <cob_object_detection_msgs/DetectObjects.h>
+#include <opencv2/opencv.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Kinematic simulation of a robot with omnidirectional base, pan/tilt camera and arm for offline runs without hardware.
+// Velocity and joint commands are integrated with first-order dynamics on a simulation thread, which publishes
+// the robot's TF tree (base_frame -> child_frame_name, base_frame -> torso_lower_frame -> torso_upper_frame -> camera_frame
+// -> camera_optical_frame) built from a ground-truth calibration as well as the joint states.
+// Observations are synthesized from the landmark frames available in TF (e.g. the static transform publishers of the
+// launch files): a rendered checkerboard image on camera_image_topic and a get_fiducials service that reports all
+// visible Pi tag frames with measurement noise.
+// The arm is only simulated on joint level, its forward kinematics are not modeled.
+class SimulationInterface : public CalibrationInterface
+{
+protected:
+	// ground truth and frames
+	std::string base_frame_;
+	std::string child_frame_name_;
+	std::string torso_lower_frame_;
+	std::string torso_upper_frame_;
+	std::string camera_frame_;
+	std::string camera_optical_frame_;
+	std::string checkerboard_frame_;
+	std::string marker_frame_base_name_;
+	tf::Transform T_base_to_torso_lower_description_;		// transforms published to TF, i.e. the uncalibrated robot description
+	tf::Transform T_torso_upper_to_camera_description_;
+	tf::Transform T_base_to_torso_lower_;		// ground truth used for the observations = description * calibration error
+	tf::Transform T_torso_upper_to_camera_;
+	tf::Transform T_camera_to_camera_optical_;
+
+	// dynamics
+	double simulation_rate_;		// [Hz] integration and TF publishing rate
+	double base_time_constant_;		// [s] first-order lag of the base velocity
+	double joint_time_constant_;	// [s] first-order lag of the camera and arm joints
+	boost::mutex state_mutex_;		// secures the commands and the simulated state below
+	geometry_msgs::Twist commanded_velocity_;
+	ros::Time commanded_velocity_time_;
+	double base_pose_[3];		// x, y, phi of base_frame in child_frame_name
+	double base_velocity_[3];	// vx, vy, omega in base_frame
+	std::vector<double> camera_joints_;
+	std::vector<double> camera_joints_target_;
+	std::vector<double> arm_joints_;
+	std::vector<double> arm_joints_target_;
+	std::vector<std::string> camera_joint_names_;
+	std::vector<std::string> arm_joint_names_;
+	JointStateBuffer camera_state_current_;
+	JointStateBuffer arm_state_current_;
+	ros::Time published_stamp_;		// time stamp of the last published state
+	tf::Transform published_T_base_to_reference_;		// pose of child_frame_name at published_stamp_
+	tf::Transform published_T_base_to_camera_optical_;		// true camera pose at published_stamp_
+
+	// observations
+	cv::Mat camera_matrix_;		// 3x3 intrinsics of the simulated camera
+	cv::Size image_size_;
+	double image_rate_;		// [Hz]
+	double detection_noise_;		// [m] standard deviation of the simulated marker positions
+	cv::Size chessboard_pattern_size_;
+	double chessboard_cell_size_;
+	cv::RNG rng_;
+	boost::mutex rng_mutex_;
+
+	tf::TransformBroadcaster transform_broadcaster_;
+	tf::TransformListener transform_listener_;
+	ros::Publisher joint_state_pub_;
+	ros::Publisher camera_info_pub_;
+	image_transport::ImageTransport* it_;
+	image_transport::Publisher image_pub_;
+	ros::CallbackQueue service_queue_;		// the fiducial service is called from the calibration's main thread, so it is served independently
+	ros::AsyncSpinner* service_spinner_;
+	ros::ServiceServer fiducials_service_;
+
+	boost::thread simulation_thread_;
+	boost::atomic<bool> running_;
+
+	// integrates the commands and publishes TF, joint states and images
+	void simulationThread();
+
+	// first-order lag of value towards target with time constant tau
+	static double firstOrder(const double value, const double target, const double dt, const double tau);
+
+	// reads a transform given as x, y, z, yaw, pitch, roll
+	tf::Transform readTransformParameter(const std::string& name, const tf::Transform& default_transform);
+
+	// publishes the robot's TF tree and joint states of the current state, must be called with state_mutex_ locked
+	void publishState(const ros::Time& stamp);
+
+	// renders the checkerboard as seen from the true camera pose
+	void publishImage(const ros::Time& stamp, const tf::Transform& T_base_to_reference, const tf::Transform& T_base_to_camera_optical);
+
+	// true pose of a landmark frame in camera_optical_frame coordinates, the landmark is looked up relative to child_frame_name
+	bool getLandmarkInCamera(const std::string& landmark_frame, const tf::Transform& T_base_to_reference, const tf::Transform& T_base_to_camera_optical,
+			tf::Transform& T_camera_optical_to_landmark);
+
+	// projects a point given in camera_optical_frame coordinates into the image, returns false if it is behind the camera
+	bool project(const tf::Vector3& point, cv::Point& pixel) const;
+
+	// returns true if the point given in camera_optical_frame coordinates projects into the image
+	bool isVisible(const tf::Vector3& point) const;
+
+	bool detectFiducialsCallback(cob_object_detection_msgs::DetectObjects::Request& req, cob_object_detection_msgs::DetectObjects::Response& res);
+
+public:
+	SimulationInterface(ros::NodeHandle nh, bool do_arm_calibration);
+	~SimulationInterface();
+
+	// general functions
+	void getParameterNames(std::vector<std::string>& parameter_names);
+
+	// camera calibration interface
+	void assignNewRobotVelocity(geometry_msgs::Twist new_velocity);
+	void assignNewCameraAngles(std_msgs::Float64MultiArray new_angles);
+	JointStateSnapshot getCurrentCameraState();
+
+	// arm calibration interface
+	void assignNewArmJoints(std_msgs::Float64MultiArray new_joint_config);
+	JointStateSnapshot getCurrentArmState();
+};
+
+
+#endif /* SIMULATION_INTERFACE_H_ */
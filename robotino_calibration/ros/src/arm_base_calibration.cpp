@@ -51,6 +51,7 @@
 
 #include <robotino_calibration/arm_base_calibration.h>
 #include <robotino_calibration/transformation_utilities.h>
+#include <robotino_calibration/extrinsic_solver.h>
 #include <std_msgs/Float64MultiArray.h>
 #include <geometry_msgs/Point.h>
 #include <pcl/point_types.h>
@@ -58,9 +59,16 @@
 #include <sstream>
 #include <fstream>
 #include <numeric>
+#include <boost/bind.hpp>
 #include <robotino_calibration/timer.h>
 
 
+static const int CHECKERBOARD_DETECTION_FLAGS = cv::CALIB_CB_ADAPTIVE_THRESH + cv::CALIB_CB_NORMALIZE_IMAGE + cv::CALIB_CB_FAST_CHECK;
+static const cv::Size SUBPIXEL_WINDOW_SIZE(11,11);
+static const int SUBPIXEL_MAX_ITERATIONS = 30;
+static const double SUBPIXEL_EPSILON = 0.1;
+
+
 //ToDo: Adjust displayAndSaveCalibrationResult() for new EndeffToChecker or remove the optimization for it.
 //ToDo: Add new setting to define the timeout time (move camera, move robot)
 //ToDo: Rename armbase_to_endeff to armbase_to_checkerboard
@@ -307,7 +315,7 @@ bool ArmBaseCalibration::moveArm(const calibration_utilities::AngleConfiguration
 	for ( int i=0; i<new_joint_config.data.size(); ++i )
 		new_joint_config.data[i] = arm_configuration.angles_[i];
 
-	std::vector<double> cur_state = *calibration_interface_->getCurrentArmState();
+	std::vector<double> cur_state = calibration_interface_->getCurrentArmState().positions_;
 	if ( cur_state.size() != arm_configuration.angles_.size() )
 	{
 		ROS_ERROR("Size of target arm configuration and count of arm joints do not match! Please adjust the yaml file.");
@@ -321,7 +329,7 @@ bool ArmBaseCalibration::moveArm(const calibration_utilities::AngleConfiguration
 
 		do
 		{
-			cur_state = *calibration_interface_->getCurrentArmState();
+			cur_state = calibration_interface_->getCurrentArmState().positions_;
 			delta_angle = arm_configuration.angles_[i] - cur_state[i];
 
 			while (delta_angle < -CV_PI)
@@ -349,14 +357,12 @@ bool ArmBaseCalibration::moveArm(const calibration_utilities::AngleConfiguration
 	calibration_interface_->assignNewArmJoints(new_joint_config);
 
 	//Wait for arm to move
-	if ( (*calibration_interface_->getCurrentArmState()).size() > 0 )
+	if ( calibration_interface_->getCurrentArmState().positions_.size() > 0 )
 	{
 		Timer timeout;
 		while (timeout.getElapsedTimeInSec()<10.0) //Max. 10 seconds to reach goal
 		{
-
-			boost::mutex::scoped_lock(arm_state_data_mutex_);
-			cur_state = *calibration_interface_->getCurrentArmState();
+			cur_state = calibration_interface_->getCurrentArmState().positions_;
 			std::vector<double> difference(cur_state.size());
 			for (int i = 0; i<cur_state.size(); ++i)
 				difference[i] = arm_configuration.angles_[i]-cur_state[i];
@@ -395,7 +401,7 @@ bool ArmBaseCalibration::moveCamera(const calibration_utilities::AngleConfigurat
 	for ( int i=0; i<angles.data.size(); ++i )
 		angles.data[i] = cam_configuration.angles_[i];
 
-	std::vector<double> cur_state = *calibration_interface_->getCurrentCameraState();
+	std::vector<double> cur_state = calibration_interface_->getCurrentCameraState().positions_;
 	if ( cur_state.size() != cam_configuration.angles_.size() )
 	{
 		ROS_ERROR("Size of target camera configuration and count of camera joints do not match! Please adjust the yaml file.");
@@ -410,7 +416,7 @@ bool ArmBaseCalibration::moveCamera(const calibration_utilities::AngleConfigurat
 		Timer timeout;
 		while (timeout.getElapsedTimeInSec()<10.0)
 		{
-			cur_state = *calibration_interface_->getCurrentCameraState();
+			cur_state = calibration_interface_->getCurrentCameraState().positions_;
 			std::vector<double> difference(cur_state.size());
 			for (int i = 0; i<cur_state.size(); ++i)
 				difference[i] = cam_configuration.angles_[i]-cur_state[i];
@@ -449,111 +455,149 @@ bool ArmBaseCalibration::acquireCalibrationImages(const cv::Size pattern_size, c
 {
 	// capture images from different perspectives
 	const int number_images_to_capture = (int)arm_configurations_.size();
-	for (int image_counter = 0; image_counter < number_images_to_capture; ++image_counter)
+	AcquisitionCheckpoint checkpoint(calibration_storage_path_ + "acquisition_checkpoint.txt", number_images_to_capture,
+			AcquisitionCheckpoint::describeSession("arm_checkerboard", arm_configurations_, camera_configurations_));
+	const std::string archive_path = calibration_storage_path_ + "session_archive.bin";
+	SessionArchiveWriter archive_writer;
+	if (!load_images)
 	{
-		if ( !ros::ok() )
-			return false;
-
-		std::cout << "Configuration " << (image_counter+1) << "/" << number_images_to_capture << std::endl;
+		startAcquisitionSession(checkpoint);
+		archive_writer.open(archive_path, checkpoint.getCapturedCount() > 0);
+	}
+	SessionArchiveReader archive_reader;
+	DetectionCache detection_cache;
+	if (load_images || checkpoint.getCapturedCount() > 0)
+	{
+		archive_reader.open(archive_path);
+		detection_cache.open(calibration_storage_path_ + "detection_cache.bin");
+	}
 
-		if (!load_images)
+	// captured views are processed (checkerboard detection, saving) while the arm already moves to the next configuration
+	std::vector<ArmView> views(number_images_to_capture);
+	{
+		AcquisitionPipeline pipeline((load_images ? 0 : acquisition_worker_threads_), acquisition_queue_size_);
+		for (int image_counter = 0; image_counter < number_images_to_capture; ++image_counter)
 		{
-			moveCamera(camera_configurations_[image_counter]);
-			moveArm(arm_configurations_[image_counter]);
-		}
+			if ( !ros::ok() )
+				return false;
 
-		// acquire image and extract checkerboard points
-		std::vector<cv::Point2f> checkerboard_points_2d;
-		int return_value = acquireCalibrationImage(image_width, image_height, checkerboard_points_2d, pattern_size, load_images, image_counter);
-		if (return_value != 0)
-			continue;
+			std::cout << "Configuration " << (image_counter+1) << "/" << number_images_to_capture << std::endl;
 
-		// retrieve transformations
-		cv::Mat T_armbase_to_checkerboard, T_base_to_camera_optical;
-		std::stringstream path;
-		path << calibration_storage_path_ << image_counter << ".yml";
-		if (load_images)
-		{
-			cv::FileStorage fs(path.str().c_str(), cv::FileStorage::READ);
-			if (fs.isOpened())
-			{
-				fs["T_armbase_to_checkerboard"] >> T_armbase_to_checkerboard;
-				fs["T_base_to_camera_optical"] >> T_base_to_camera_optical;
-			}
-			else
+			// configurations captured before an interruption are loaded from disk instead of being approached again
+			ArmView& view = views[image_counter];
+			if (load_images || checkpoint.isCaptured(image_counter))
 			{
-				ROS_WARN("Could not read transformations from file '%s'.", path.str().c_str());
+				loadView(archive_reader, detection_cache, image_counter, pattern_size, view);
 				continue;
 			}
-			fs.release();
-		}
-		else
-		{
-			bool result = true;
-			result &= transform_utilities::getTransform(transform_listener_, armbase_frame_, checkerboard_frame_, T_armbase_to_checkerboard);
-			result &= transform_utilities::getTransform(transform_listener_, base_frame_, camera_optical_frame_, T_base_to_camera_optical);
 
+			Timer move_time;
+			moveCamera(camera_configurations_[image_counter]);
+			moveArm(arm_configurations_[image_counter]);
+			pipeline.addStageTime(AcquisitionPipeline::STAGE_MOVE, move_time.getElapsedTimeInSec());
+
+			// freeze image and transforms of this view, the transforms are taken at the time stamp of the image
+			Timer capture_time;
+			ros::Time image_stamp;
+			if (captureImage(view.image_, image_stamp) != 0)
+				continue;
+			std::vector<transform_utilities::FramePair> frame_pairs;
+			frame_pairs.push_back(transform_utilities::FramePair(armbase_frame_, checkerboard_frame_));
+			frame_pairs.push_back(transform_utilities::FramePair(base_frame_, camera_optical_frame_));
+			std::vector<cv::Mat> transforms;
+			bool result = transform_utilities::getTransforms(transform_listener_, frame_pairs, image_stamp, transform_lookup_timeout_, transforms);
+			pipeline.addStageTime(AcquisitionPipeline::STAGE_CAPTURE, capture_time.getElapsedTimeInSec());
 			if (result == false)
 				continue;
+			view.T_armbase_to_checkerboard_ = transforms[0];
+			view.T_base_to_camera_optical_ = transforms[1];
 
-			// save transforms to file
-			cv::FileStorage fs(path.str().c_str(), cv::FileStorage::WRITE);
-			if (fs.isOpened())
-			{
-				fs << "T_armbase_to_checkerboard" << T_armbase_to_checkerboard;
-				fs << "T_base_to_camera_optical" << T_base_to_camera_optical;
-			}
-			else
-			{
-				ROS_WARN("Could not write transformations to file '%s'.", path.str().c_str());
-				continue;
-			}
-			fs.release();
+			pipeline.enqueue(boost::bind(&ArmBaseCalibration::processView, this, image_counter, pattern_size, boost::ref(view), boost::ref(archive_writer), boost::ref(checkpoint)));
 		}
 
-		points_2d_per_image.push_back(checkerboard_points_2d);
-		T_armbase_to_checkerboard_vector.push_back(T_armbase_to_checkerboard);
-		T_base_to_camera_optical_vector.push_back(T_base_to_camera_optical);
-		std::cout << "Captured perspectives: " << points_2d_per_image.size() << std::endl;
+		pipeline.waitUntilIdle();
+		if (!load_images)
+			pipeline.printStatistics();
+		else
+			detection_cache.printStatistics();
 	}
 
+	// collect the successfully processed views in the order of the arm configurations
+	for (size_t i=0; i<views.size(); ++i)
+	{
+		if (views[i].valid_ == false)
+			continue;
+
+		image_width = views[i].image_size_.width;
+		image_height = views[i].image_size_.height;
+		points_2d_per_image.push_back(views[i].checkerboard_points_2d_);
+		T_armbase_to_checkerboard_vector.push_back(views[i].T_armbase_to_checkerboard_);
+		T_base_to_camera_optical_vector.push_back(views[i].T_base_to_camera_optical_);
+	}
+	std::cout << "Captured perspectives: " << points_2d_per_image.size() << std::endl;
+
 	return true;
 }
 
-int ArmBaseCalibration::acquireCalibrationImage(int& image_width, int& image_height,
-		std::vector<cv::Point2f>& checkerboard_points_2d, const cv::Size pattern_size, const bool load_images, int& image_counter)
+int ArmBaseCalibration::captureImage(cv::Mat& image, ros::Time& stamp)
 {
-	int return_value = 0;
+	ros::Duration(3).sleep();
+	capture_image_ = true;
+	ros::spinOnce();
+	ros::Duration(2).sleep();
 
-	// acquire image
-	cv::Mat image, gray;
-	if (load_images == false)
-	{
-		ros::Duration(3).sleep();
-		capture_image_ = true;
-		ros::spinOnce();
-		ros::Duration(2).sleep();
+	// retrieve image from camera
+	boost::mutex::scoped_lock lock(camera_data_mutex_);
 
-		// retrieve image from camera
-		{
-			boost::mutex::scoped_lock lock(camera_data_mutex_);
+	std::cout << "Time diff: " << (ros::Time::now() - latest_image_time_).toSec() << std::endl;
 
-			std::cout << "Time diff: " << (ros::Time::now() - latest_image_time_).toSec() << std::endl;
+	if ((ros::Time::now() - latest_image_time_).toSec() < 20.0)
+	{
+		image = camera_image_.clone();
+		stamp = latest_image_time_;
+	}
+	else
+	{
+		ROS_WARN("Did not receive camera images recently.");
+		return -1;		// -1 = no fresh image available
+	}
 
-			if ((ros::Time::now() - latest_image_time_).toSec() < 20.0)
-			{
-				image = camera_image_.clone();
+	return 0;
+}
 
-				// convert to grayscale
-				gray = cv::Mat::zeros(image.rows, image.cols, CV_8UC1);
-				cv::cvtColor(image, gray, CV_BGR2GRAY);
-			}
-			else
-			{
-				ROS_WARN("Did not receive camera images recently.");
-				return -1;		// -1 = no fresh image available
-			}
+bool ArmBaseCalibration::loadView(const SessionArchiveReader& archive, DetectionCache& detection_cache, const int image_counter,
+		const cv::Size pattern_size, ArmView& view)
+{
+	const std::string detector_settings = getDetectorSettings(pattern_size);
+	view.valid_ = false;
+	SessionArchiveRecord record;
+	uint64_t image_hash = 0;
+	bool image_stored = true;
+	if (archive.hasView(image_counter))
+	{
+		archive.read(image_counter, record, false);
+		if (record.transforms_.size() != 2)
+		{
+			ROS_WARN("Inconsistent data of view %d in the session archive.", image_counter);
+			return false;
+		}
+		view.T_armbase_to_checkerboard_ = record.transforms_[0];
+		view.T_base_to_camera_optical_ = record.transforms_[1];
+		view.image_size_ = record.image_size_;
+
+		// the stored corners can be used as long as the detector settings have not changed
+		if (record.labels_.size() == 1 && record.labels_[0] == detector_settings)
+		{
+			view.checkerboard_points_2d_ = record.corners_;
+			view.valid_ = (view.checkerboard_points_2d_.size() == pattern_size.height*pattern_size.width);
+			return true;
 		}
+
+		// the encoded image identifies the image content, it is only decoded if the detector has to run
+		archive.read(image_counter, record, true);
+		image_stored = (record.image_data_.empty() == false);
+		if (image_stored)
+			image_hash = DetectionCache::hashData(&record.image_data_[0], record.image_data_.size());
 	}
 	else
 	{
@@ -561,66 +605,128 @@ int ArmBaseCalibration::acquireCalibrationImage(int& image_width, int& image_hei
 		std::stringstream ss;
 		ss << calibration_storage_path_ << image_counter;
 		std::string image_name = ss.str() + ".png";
-		gray = cv::imread(image_name.c_str(), CV_LOAD_IMAGE_GRAYSCALE);
-		if (gray.empty())
-			return -2;
-	}
-	image_width = gray.cols;
-	image_height = gray.rows;
+		view.gray_ = cv::imread(image_name.c_str(), CV_LOAD_IMAGE_GRAYSCALE);
+		if (view.gray_.empty())
+			return false;
+		view.image_size_ = view.gray_.size();
+		image_hash = DetectionCache::hashImage(view.gray_);
 
-	// find pattern in image
-	bool pattern_found = cv::findChessboardCorners(gray, pattern_size, checkerboard_points_2d,
-								cv::CALIB_CB_ADAPTIVE_THRESH + cv::CALIB_CB_NORMALIZE_IMAGE + cv::CALIB_CB_FAST_CHECK);
+		// load transforms from file
+		std::string path = ss.str() + ".yml";
+		cv::FileStorage fs(path.c_str(), cv::FileStorage::READ);
+		if (fs.isOpened())
+		{
+			fs["T_armbase_to_checkerboard"] >> view.T_armbase_to_checkerboard_;
+			fs["T_base_to_camera_optical"] >> view.T_base_to_camera_optical_;
+		}
+		else
+		{
+			ROS_WARN("Could not read transformations from file '%s'.", path.c_str());
+			view.gray_.release();
+			return false;
+		}
+		fs.release();
+	}
 
-	if ( pattern_found )
+	bool found = false;
+	if (image_stored && detection_cache.lookup(image_hash, detector_settings, found, view.checkerboard_points_2d_) == true)
 	{
-        cv::cornerSubPix( gray, checkerboard_points_2d, cv::Size(11,11),
-        		cv::Size(-1,-1), cv::TermCriteria( cv::TermCriteria::EPS+cv::TermCriteria::COUNT, 30, 0.1 ));
+		view.valid_ = (found && view.checkerboard_points_2d_.size() == pattern_size.height*pattern_size.width);
+		if (view.valid_ == false)
+			ROS_WARN("Not all checkerboard points have been observed.");
+		view.gray_.release();
+		return true;
 	}
 
-	// collect 2d points
-	if (checkerboard_points_2d.size() == pattern_size.height*pattern_size.width)
+	// views stored in corner-only mode have no full image, their detection cannot be repeated with the current settings
+	if (view.gray_.empty() && (record.decodeImage(view.gray_, CV_LOAD_IMAGE_GRAYSCALE) == false || view.gray_.size() != view.image_size_))
 	{
-		// save images
-		if (load_images == false)
-		{
-			std::stringstream ss;
-			ss << calibration_storage_path_ << image_counter;
-			std::string image_name = ss.str() + ".png";
-			cv::imwrite(image_name.c_str(), image);
-		}
+		ROS_WARN("The session archive does not contain the full image of view %d, using the stored corners.", image_counter);
+		view.gray_.release();
+		view.checkerboard_points_2d_ = record.corners_;
+		view.valid_ = (view.checkerboard_points_2d_.size() == pattern_size.height*pattern_size.width);
+		return true;
 	}
-	else
+	detectCheckerboard(view, pattern_size);
+	detection_cache.insert(image_hash, detector_settings, view.valid_, view.checkerboard_points_2d_);
+	view.gray_.release();		// the detected corners are all that is needed from the image
+
+	return true;
+}
+
+void ArmBaseCalibration::processView(const int image_counter, const cv::Size pattern_size, ArmView& view, SessionArchiveWriter& archive,
+		AcquisitionCheckpoint& checkpoint)
+{
+	// convert to grayscale
+	view.gray_ = cv::Mat::zeros(view.image_.rows, view.image_.cols, CV_8UC1);
+	cv::cvtColor(view.image_, view.gray_, CV_BGR2GRAY);
+
+	// failed detections are only stored in corner-only mode for debugging
+	const bool pattern_found = detectCheckerboard(view, pattern_size);
+	view.image_size_ = view.image_.size();
+	if (pattern_found == true || image_storage_mode_ == "corners")
+		saveView(image_counter, pattern_size, pattern_found, view, archive, checkpoint);
+
+	// only the image size, the corners and the transforms are used from here on, the frames of all views would be kept until the end of the session otherwise
+	view.image_.release();
+	view.gray_.release();
+}
+
+void ArmBaseCalibration::saveView(const int image_counter, const cv::Size pattern_size, const bool pattern_found, ArmView& view, SessionArchiveWriter& archive,
+		AcquisitionCheckpoint& checkpoint)
+{
+	// append image, corners and transforms to the session archive, the view is recorded in the checkpoint once it is complete on disk
+	view.valid_ = false;
+	SessionArchiveRecord record;
+	record.view_index_ = image_counter;
+	record.transforms_.push_back(view.T_armbase_to_checkerboard_);
+	record.transforms_.push_back(view.T_base_to_camera_optical_);
+	record.corners_ = view.checkerboard_points_2d_;
+	record.labels_.push_back(getDetectorSettings(pattern_size));
+	if (storeViewImage(view.image_, pattern_found, record) == false || archive.write(record) == false)
 	{
-		ROS_WARN("Not all checkerboard points have been observed.");
-		return_value = -2;
+		ROS_WARN("Could not save view %d to the session archive.", image_counter);
+		return;
 	}
+	if (pattern_found == false)
+		return;
 
-	return return_value;
+	checkpoint.markCaptured(image_counter);
+	view.valid_ = true;
 }
 
-void ArmBaseCalibration::extrinsicCalibrationBaseToArm(std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
-		std::vector<cv::Mat>& T_base_to_checkerboard_vector, std::vector<cv::Mat>& T_armbase_to_checkerboard_vector )
+std::string ArmBaseCalibration::getDetectorSettings(const cv::Size pattern_size) const
 {
-	// transform 3d chessboard points to respective coordinates systems (base and arm base)
-	std::vector<cv::Point3d> points_3d_base, points_3d_armbase;
-	for (size_t i=0; i<pattern_points_3d.size(); ++i)
-	{
-		for (size_t j=0; j<pattern_points_3d[i].size(); ++j)
-		{
-			cv::Mat point = cv::Mat(cv::Vec4d(pattern_points_3d[i][j].x, pattern_points_3d[i][j].y, pattern_points_3d[i][j].z, 1.0));
+	std::stringstream settings;
+	settings << "findChessboardCorners pattern " << pattern_size.width << "x" << pattern_size.height << " flags " << CHECKERBOARD_DETECTION_FLAGS
+			<< " cornerSubPix window " << SUBPIXEL_WINDOW_SIZE.width << "x" << SUBPIXEL_WINDOW_SIZE.height << " iterations " << SUBPIXEL_MAX_ITERATIONS
+			<< " epsilon " << SUBPIXEL_EPSILON;
+	return settings.str();
+}
 
-			// to base coordinate system
-			cv::Mat point_base = T_base_to_checkerboard_vector[i] * point; // from base to camera to checkerboard corners
-			points_3d_base.push_back(cv::Point3d(point_base.at<double>(0), point_base.at<double>(1), point_base.at<double>(2)));
+bool ArmBaseCalibration::detectCheckerboard(ArmView& view, const cv::Size pattern_size)
+{
+	// find pattern in image
+	bool pattern_found = cv::findChessboardCorners(view.gray_, pattern_size, view.checkerboard_points_2d_, CHECKERBOARD_DETECTION_FLAGS);
 
-			// to armbase coordinate
-			cv::Mat point_armbase = T_armbase_to_checkerboard_vector[i] * point; // from arm base to checkerboard corners
-			points_3d_armbase.push_back(cv::Point3d(point_armbase.at<double>(0), point_armbase.at<double>(1), point_armbase.at<double>(2)));
-		}
+	if ( pattern_found )
+	{
+        cv::cornerSubPix( view.gray_, view.checkerboard_points_2d_, SUBPIXEL_WINDOW_SIZE,
+        		cv::Size(-1,-1), cv::TermCriteria( cv::TermCriteria::EPS+cv::TermCriteria::COUNT, SUBPIXEL_MAX_ITERATIONS, SUBPIXEL_EPSILON ));
 	}
 
-	T_base_to_armbase_ = transform_utilities::computeExtrinsicTransform(points_3d_base, points_3d_armbase);
+	// collect 2d points
+	view.valid_ = (view.checkerboard_points_2d_.size() == pattern_size.height*pattern_size.width);
+	if (view.valid_ == false)
+		ROS_WARN("Not all checkerboard points have been observed.");
+
+	return view.valid_;
+}
+
+void ArmBaseCalibration::extrinsicCalibrationBaseToArm(std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
+		std::vector<cv::Mat>& T_base_to_checkerboard_vector, std::vector<cv::Mat>& T_armbase_to_checkerboard_vector )
+{
+	T_base_to_armbase_ = extrinsic_solver::estimateBaseToArmbase(pattern_points_3d, T_base_to_checkerboard_vector, T_armbase_to_checkerboard_vector);
 }
 
 bool ArmBaseCalibration::saveCalibration()
@@ -56,11 +56,13 @@
 #include <robotino_calibration/robotino_interface.h>
 #include <robotino_calibration/raw_interface.h>
 #include <robotino_calibration/cob_interface.h>
+#include <robotino_calibration/simulation_interface.h>
 
 // Robot types
 #define Robotino	0
 #define RobAtWork	1
 #define CareOBot	2
+#define Simulation	3
 
 
 //ToDo: Generalize robot_configuration as well, so that it only uses PositionConfiguration and AngleConfiguration -> more flexible
@@ -92,6 +94,9 @@ CalibrationInterface* CalibrationInterface::createInterfaceByID(int ID, ros::Nod
 		case CareOBot:
 				return (new CobInterface(nh, bArmCalibration));
 				break;
+		case Simulation:
+				return (new SimulationInterface(nh, bArmCalibration));
+				break;
 		default:
 				return 0;
 	}
@@ -57,8 +57,11 @@
 #include <pcl/registration/icp.h>
 
 #include <sstream>
+#include <boost/bind.hpp>
 
 
+static const int CHECKERBOARD_DETECTION_FLAGS = cv::CALIB_CB_FAST_CHECK + cv::CALIB_CB_FILTER_QUADS;
+
 CameraBaseCalibrationCheckerboard::CameraBaseCalibrationCheckerboard(ros::NodeHandle nh) :
 			CameraBaseCalibrationMarker(nh)
 {
@@ -183,110 +186,152 @@ bool CameraBaseCalibrationCheckerboard::acquireCalibrationImages(const std::vect
 {
 	// capture images from different perspectives
 	const int number_images_to_capture = (int)robot_configurations.size();
-	for (int image_counter = 0; image_counter < number_images_to_capture; ++image_counter)
+	AcquisitionCheckpoint checkpoint(calibration_storage_path_ + "acquisition_checkpoint.txt", number_images_to_capture,
+			AcquisitionCheckpoint::describeSession("checkerboard", robot_configurations));
+	const std::string archive_path = calibration_storage_path_ + "session_archive.bin";
+	SessionArchiveWriter archive_writer;
+	if (!load_images)
 	{
-		if ( !ros::ok() )
-			return false;
-
-		std::cout << "Configuration " << (image_counter+1) << "/" << number_images_to_capture << std::endl;
+		startAcquisitionSession(checkpoint);
+		archive_writer.open(archive_path, checkpoint.getCapturedCount() > 0);
+	}
+	SessionArchiveReader archive_reader;
+	DetectionCache detection_cache;
+	if (load_images || checkpoint.getCapturedCount() > 0)
+	{
+		archive_reader.open(archive_path);
+		detection_cache.open(calibration_storage_path_ + "detection_cache.bin");
+	}
 
-		if (!load_images)
-			moveRobot(robot_configurations[image_counter]);
+	// captured views are processed (checkerboard detection, saving) while the robot already moves to the next configuration
+	std::vector<CheckerboardView> views(number_images_to_capture);
+	{
+		AcquisitionPipeline pipeline((load_images ? 0 : acquisition_worker_threads_), acquisition_queue_size_);
+		for (int image_counter = 0; image_counter < number_images_to_capture; ++image_counter)
+		{
+			if ( !ros::ok() )
+				return false;
 
-		// acquire image and extract checkerboard points
-		std::vector<cv::Point2f> checkerboard_points_2d;
-		int return_value = acquireCalibrationImage(image_width, image_height, checkerboard_points_2d, pattern_size, load_images, image_counter);
-		if (return_value != 0)
-			continue;
+			std::cout << "Configuration " << (image_counter+1) << "/" << number_images_to_capture << std::endl;
 
-		// retrieve transformations
-		cv::Mat T_base_to_checkerboard, T_torso_lower_to_torso_upper, T_camera_to_camera_optical;
-		std::stringstream path;
-		path << calibration_storage_path_ << image_counter << ".yml";
-		if (load_images)
-		{
-			cv::FileStorage fs(path.str().c_str(), cv::FileStorage::READ);
-			if (fs.isOpened())
+			// configurations captured before an interruption are loaded from disk instead of being approached again
+			CheckerboardView& view = views[image_counter];
+			if (load_images || checkpoint.isCaptured(image_counter))
 			{
-				fs["T_base_to_checkerboard"] >> T_base_to_checkerboard;
-				fs["T_torso_lower_to_torso_upper"] >> T_torso_lower_to_torso_upper;
-				fs["T_camera_to_camera_optical"] >> T_camera_to_camera_optical;
-			}
-			else
-			{
-				ROS_WARN("Could not read transformations from file '%s'.", path.str().c_str());
+				loadView(archive_reader, detection_cache, image_counter, pattern_size, view);
 				continue;
 			}
-			fs.release();
-		}
-		else
-		{
-			bool result = true;
-			result &= transform_utilities::getTransform(transform_listener_, base_frame_, checkerboard_frame_, T_base_to_checkerboard);
-			result &= transform_utilities::getTransform(transform_listener_, torso_lower_frame_, torso_upper_frame_, T_torso_lower_to_torso_upper);
-			result &= transform_utilities::getTransform(transform_listener_, camera_frame_, camera_optical_frame_, T_camera_to_camera_optical);
 
+			Timer move_time;
+			moveRobot(robot_configurations[image_counter]);
+			pipeline.addStageTime(AcquisitionPipeline::STAGE_MOVE, move_time.getElapsedTimeInSec());
+
+			// freeze image and transforms of this view, the transforms are taken at the time stamp of the image
+			Timer capture_time;
+			ros::Time image_stamp;
+			if (captureImage(view.image_, image_stamp) != 0)
+				continue;
+			std::vector<transform_utilities::FramePair> frame_pairs;
+			frame_pairs.push_back(transform_utilities::FramePair(base_frame_, checkerboard_frame_));
+			frame_pairs.push_back(transform_utilities::FramePair(torso_lower_frame_, torso_upper_frame_));
+			std::vector<cv::Mat> transforms;
+			bool result = transform_utilities::getTransforms(transform_listener_, frame_pairs, image_stamp, transform_lookup_timeout_, transforms);
+			result = result && static_transform_cache_.getTransform(camera_frame_, camera_optical_frame_, image_stamp, transform_lookup_timeout_, view.T_camera_to_camera_optical_);
+			pipeline.addStageTime(AcquisitionPipeline::STAGE_CAPTURE, capture_time.getElapsedTimeInSec());
 			if (result == false)
 				continue;
+			view.T_base_to_checkerboard_ = transforms[0];
+			view.T_torso_lower_to_torso_upper_ = transforms[1];
 
-			// save transforms to file
-			cv::FileStorage fs(path.str().c_str(), cv::FileStorage::WRITE);
-			if (fs.isOpened())
-			{
-				fs << "T_base_to_checkerboard" << T_base_to_checkerboard;
-				fs << "T_torso_lower_to_torso_upper" << T_torso_lower_to_torso_upper;
-				fs << "T_camera_to_camera_optical" << T_camera_to_camera_optical;
-			}
-			else
-			{
-				ROS_WARN("Could not write transformations to file '%s'.", path.str().c_str());
-				continue;
-			}
-			fs.release();
+			pipeline.enqueue(boost::bind(&CameraBaseCalibrationCheckerboard::processView, this, image_counter, pattern_size, boost::ref(view), boost::ref(archive_writer), boost::ref(checkpoint)));
 		}
 
-		points_2d_per_image.push_back(checkerboard_points_2d);
-		T_base_to_checkerboard_vector.push_back(T_base_to_checkerboard);
-		T_torso_lower_to_torso_upper_vector.push_back(T_torso_lower_to_torso_upper);
-		T_camera_to_camera_optical_vector.push_back(T_camera_to_camera_optical);
+		pipeline.waitUntilIdle();
+		if (!load_images)
+			pipeline.printStatistics();
+		else
+			detection_cache.printStatistics();
+	}
+
+	// collect the successfully processed views in the order of the robot configurations
+	for (size_t i=0; i<views.size(); ++i)
+	{
+		if (views[i].valid_ == false)
+			continue;
 
-		std::cout << "Captured perspectives: " << points_2d_per_image.size() << std::endl;
+		image_width = views[i].image_size_.width;
+		image_height = views[i].image_size_.height;
+		points_2d_per_image.push_back(views[i].checkerboard_points_2d_);
+		T_base_to_checkerboard_vector.push_back(views[i].T_base_to_checkerboard_);
+		T_torso_lower_to_torso_upper_vector.push_back(views[i].T_torso_lower_to_torso_upper_);
+		T_camera_to_camera_optical_vector.push_back(views[i].T_camera_to_camera_optical_);
 	}
+	std::cout << "Captured perspectives: " << points_2d_per_image.size() << std::endl;
 
 	return true;
 }
 
-int CameraBaseCalibrationCheckerboard::acquireCalibrationImage(int& image_width, int& image_height,
-		std::vector<cv::Point2f>& checkerboard_points_2d, const cv::Size pattern_size, const bool load_images, int& image_counter)
+int CameraBaseCalibrationCheckerboard::captureImage(cv::Mat& image, ros::Time& stamp)
 {
-	int return_value = 0;
+	ros::Duration(3).sleep();
+	capture_image_ = true;
+	ros::spinOnce();
+	ros::Duration(2).sleep();
 
-	// acquire image
-	cv::Mat image;
-	if (load_images == false)
+	// retrieve image from camera
+	boost::mutex::scoped_lock lock(camera_data_mutex_);
+
+	if ( ros::ok() )
+		std::cout << "Time diff: " << (ros::Time::now() - latest_image_time_).toSec() << std::endl;
+
+	if ((ros::Time::now() - latest_image_time_).toSec() < 20.0)
 	{
-		ros::Duration(3).sleep();
-		capture_image_ = true;
-		ros::spinOnce();
-		ros::Duration(2).sleep();
+		image = camera_image_.clone();
+		stamp = latest_image_time_;
+	}
+	else
+	{
+		ROS_WARN("Did not receive camera images recently.");
+		return -1;		// -1 = no fresh image available
+	}
 
-		// retrieve image from camera
-		{
-			boost::mutex::scoped_lock lock(camera_data_mutex_);
+	return 0;
+}
 
-			if ( ros::ok() )
-				std::cout << "Time diff: " << (ros::Time::now() - latest_image_time_).toSec() << std::endl;
+bool CameraBaseCalibrationCheckerboard::loadView(const SessionArchiveReader& archive, DetectionCache& detection_cache, const int image_counter,
+		const cv::Size pattern_size, CheckerboardView& view)
+{
+	const std::string detector_settings = getDetectorSettings(pattern_size);
+	view.valid_ = false;
+	SessionArchiveRecord record;
+	uint64_t image_hash = 0;
+	bool image_stored = true;
+	if (archive.hasView(image_counter))
+	{
+		archive.read(image_counter, record, false);
+		if (record.transforms_.size() != 3)
+		{
+			ROS_WARN("Inconsistent data of view %d in the session archive.", image_counter);
+			return false;
+		}
+		view.T_base_to_checkerboard_ = record.transforms_[0];
+		view.T_torso_lower_to_torso_upper_ = record.transforms_[1];
+		view.T_camera_to_camera_optical_ = record.transforms_[2];
+		view.image_size_ = record.image_size_;
 
-			if ((ros::Time::now() - latest_image_time_).toSec() < 20.0)
-			{
-				image = camera_image_.clone();
-			}
-			else
-			{
-				ROS_WARN("Did not receive camera images recently.");
-				return -1;		// -1 = no fresh image available
-			}
+		// the stored corners can be used as long as the detector settings have not changed
+		if (record.labels_.size() == 1 && record.labels_[0] == detector_settings)
+		{
+			view.checkerboard_points_2d_ = record.corners_;
+			view.valid_ = (view.checkerboard_points_2d_.size() == pattern_size.height*pattern_size.width);
+			return true;
 		}
+
+		// the encoded image identifies the image content, it is only decoded if the detector has to run
+		archive.read(image_counter, record, true);
+		image_stored = (record.image_data_.empty() == false);
+		if (image_stored)
+			image_hash = DetectionCache::hashData(&record.image_data_[0], record.image_data_.size());
 	}
 	else
 	{
@@ -294,41 +339,120 @@ int CameraBaseCalibrationCheckerboard::acquireCalibrationImage(int& image_width,
 		std::stringstream ss;
 		ss << calibration_storage_path_ << image_counter;
 		std::string image_name = ss.str() + ".png";
-		image = cv::imread(image_name.c_str(), 0);
-		if (image.empty())
-			return -2;
+		view.image_ = cv::imread(image_name.c_str(), 0);
+		if (view.image_.empty())
+			return false;
+		view.image_size_ = view.image_.size();
+		image_hash = DetectionCache::hashImage(view.image_);
+
+		// load transforms from file
+		std::string path = ss.str() + ".yml";
+		cv::FileStorage fs(path.c_str(), cv::FileStorage::READ);
+		if (fs.isOpened())
+		{
+			fs["T_base_to_checkerboard"] >> view.T_base_to_checkerboard_;
+			fs["T_torso_lower_to_torso_upper"] >> view.T_torso_lower_to_torso_upper_;
+			fs["T_camera_to_camera_optical"] >> view.T_camera_to_camera_optical_;
+		}
+		else
+		{
+			ROS_WARN("Could not read transformations from file '%s'.", path.c_str());
+			view.image_.release();
+			return false;
+		}
+		fs.release();
 	}
-	image_width = image.cols;
-	image_height = image.rows;
 
-	// find pattern in image
-	bool pattern_found = cv::findChessboardCorners(image, pattern_size, checkerboard_points_2d, cv::CALIB_CB_FAST_CHECK + cv::CALIB_CB_FILTER_QUADS);
+	bool found = false;
+	if (image_stored && detection_cache.lookup(image_hash, detector_settings, found, view.checkerboard_points_2d_) == true)
+	{
+		view.valid_ = (found && view.checkerboard_points_2d_.size() == pattern_size.height*pattern_size.width);
+		if (view.valid_ == false)
+			ROS_WARN("Not all checkerboard points have been observed.");
+		view.image_.release();
+		return true;
+	}
 
-	// display
-	cv::Mat display = image.clone();
-	cv::drawChessboardCorners(display, pattern_size, cv::Mat(checkerboard_points_2d), pattern_found);
-	cv::imshow("image", display);
-	cv::waitKey(50);
+	// views stored in corner-only mode have no full image, their detection cannot be repeated with the current settings
+	if (view.image_.empty() && (record.decodeImage(view.image_, 0) == false || view.image_.size() != view.image_size_))
+	{
+		ROS_WARN("The session archive does not contain the full image of view %d, using the stored corners.", image_counter);
+		view.image_.release();
+		view.checkerboard_points_2d_ = record.corners_;
+		view.valid_ = (view.checkerboard_points_2d_.size() == pattern_size.height*pattern_size.width);
+		return true;
+	}
+	detectCheckerboard(view, pattern_size, true);
+	detection_cache.insert(image_hash, detector_settings, view.valid_, view.checkerboard_points_2d_);
+	view.image_.release();		// the detected corners are all that is needed from the image
 
-	// collect 2d points
-	if (checkerboard_points_2d.size() == pattern_size.height*pattern_size.width)
+	return true;
+}
+
+void CameraBaseCalibrationCheckerboard::processView(const int image_counter, const cv::Size pattern_size, CheckerboardView& view, SessionArchiveWriter& archive,
+		AcquisitionCheckpoint& checkpoint)
+{
+	// displaying is only possible from the main thread, failed detections are only stored in corner-only mode for debugging
+	const bool pattern_found = detectCheckerboard(view, pattern_size, false);
+	view.image_size_ = view.image_.size();
+	if (pattern_found == true || image_storage_mode_ == "corners")
+		saveView(image_counter, pattern_size, pattern_found, view, archive, checkpoint);
+
+	// only the image size, the corners and the transforms are used from here on, the frames of all views would be kept until the end of the session otherwise
+	view.image_.release();
+}
+
+void CameraBaseCalibrationCheckerboard::saveView(const int image_counter, const cv::Size pattern_size, const bool pattern_found, CheckerboardView& view, SessionArchiveWriter& archive,
+		AcquisitionCheckpoint& checkpoint)
+{
+	// append image, corners and transforms to the session archive, the view is recorded in the checkpoint once it is complete on disk
+	view.valid_ = false;
+	SessionArchiveRecord record;
+	record.view_index_ = image_counter;
+	record.transforms_.push_back(view.T_base_to_checkerboard_);
+	record.transforms_.push_back(view.T_torso_lower_to_torso_upper_);
+	record.transforms_.push_back(view.T_camera_to_camera_optical_);
+	record.corners_ = view.checkerboard_points_2d_;
+	record.labels_.push_back(getDetectorSettings(pattern_size));
+	if (storeViewImage(view.image_, pattern_found, record) == false || archive.write(record) == false)
 	{
-		// save images
-		if (load_images == false)
-		{
-			std::stringstream ss;
-			ss << calibration_storage_path_ << image_counter;
-			std::string image_name = ss.str() + ".png";
-			cv::imwrite(image_name.c_str(), image);
-		}
+		ROS_WARN("Could not save view %d to the session archive.", image_counter);
+		return;
 	}
-	else
+	if (pattern_found == false)
+		return;
+
+	checkpoint.markCaptured(image_counter);
+	view.valid_ = true;
+}
+
+std::string CameraBaseCalibrationCheckerboard::getDetectorSettings(const cv::Size pattern_size) const
+{
+	std::stringstream settings;
+	settings << "findChessboardCorners pattern " << pattern_size.width << "x" << pattern_size.height << " flags " << CHECKERBOARD_DETECTION_FLAGS;
+	return settings.str();
+}
+
+bool CameraBaseCalibrationCheckerboard::detectCheckerboard(CheckerboardView& view, const cv::Size pattern_size, const bool display)
+{
+	// find pattern in image
+	bool pattern_found = cv::findChessboardCorners(view.image_, pattern_size, view.checkerboard_points_2d_, CHECKERBOARD_DETECTION_FLAGS);
+
+	// display
+	if (display)
 	{
-		ROS_WARN("Not all checkerboard points have been observed.");
-		return_value = -2;
+		cv::Mat display_image = view.image_.clone();
+		cv::drawChessboardCorners(display_image, pattern_size, cv::Mat(view.checkerboard_points_2d_), pattern_found);
+		cv::imshow("image", display_image);
+		cv::waitKey(50);
 	}
 
-	return return_value;
+	// collect 2d points
+	view.valid_ = (view.checkerboard_points_2d_.size() == pattern_size.height*pattern_size.width);
+	if (view.valid_ == false)
+		ROS_WARN("Not all checkerboard points have been observed.");
+
+	return view.valid_;
 }
 
 void CameraBaseCalibrationCheckerboard::intrinsicCalibration(const std::vector< std::vector<cv::Point3f> >& pattern_points, const std::vector< std::vector<cv::Point2f> >& camera_points_2d_per_image, const cv::Size& image_size, std::vector<cv::Mat>& rvecs, std::vector<cv::Mat>& tvecs)
@@ -51,6 +51,7 @@
 
 #include <robotino_calibration/camera_base_calibration_marker.h>
 #include <robotino_calibration/transformation_utilities.h>
+#include <robotino_calibration/extrinsic_solver.h>
 
 //#include <std_msgs/Float64.h>
 #include <std_msgs/Float64MultiArray.h>
@@ -61,6 +62,8 @@
 
 #include <sstream>
 #include <fstream>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 
 // ToDo: Remove static camera angle link count of 2
 // ToDo: Pan_Range and Tilt_Range needs to be stored in one 3*X vector (X number of camera links and 3: min, step, end)
@@ -70,7 +73,7 @@
 // ToDo: Change convention of rotations from RPY to YPR inside transformations_utilities! Function says YPR already, but it is wrong! [Done, by removing function]
 
 CameraBaseCalibrationMarker::CameraBaseCalibrationMarker(ros::NodeHandle nh) :
-			RobotCalibration(nh, false), counter(0), RefHistoryIndex_(0)
+			RobotCalibration(nh, false), counter(0), RefHistoryIndex_(0), reference_pose_feed_(0), base_in_motion_(false)
 {
 	// load parameters
 	std::cout << "\n========== CameraBaseCalibrationMarker Parameters ==========\n";
@@ -87,6 +90,23 @@ CameraBaseCalibrationMarker::CameraBaseCalibrationMarker(ros::NodeHandle nh) :
 	std::cout << "optimization_iterations: " << optimization_iterations_ << std::endl;
 	node_handle_.param<std::string>("child_frame_name", child_frame_name_, "/landmark_reference_nav");
 	std::cout << "child_frame_name: " << child_frame_name_ << std::endl;
+	double reference_pose_feed_rate = 50.;
+	node_handle_.param("reference_pose_feed_rate", reference_pose_feed_rate, 50.);
+	std::cout << "reference_pose_feed_rate: " << reference_pose_feed_rate << std::endl;
+	double reference_pose_max_age = 0.5;
+	node_handle_.param("reference_pose_max_age", reference_pose_max_age, 0.5);
+	std::cout << "reference_pose_max_age: " << reference_pose_max_age << std::endl;
+	node_handle_.param("base_control_rate", base_control_rate_, 20.);
+	std::cout << "base_control_rate: " << base_control_rate_ << std::endl;
+	std::string reference_pose_covariance_topic;
+	node_handle_.param<std::string>("reference_pose_covariance_topic", reference_pose_covariance_topic, "");
+	std::cout << "reference_pose_covariance_topic: " << reference_pose_covariance_topic << std::endl;
+	node_handle_.param("max_reference_position_stddev", max_reference_position_stddev_, 0.005);
+	std::cout << "max_reference_position_stddev: " << max_reference_position_stddev_ << std::endl;
+	node_handle_.param("max_reference_angle_stddev", max_reference_angle_stddev_, 0.01);
+	std::cout << "max_reference_angle_stddev: " << max_reference_angle_stddev_ << std::endl;
+	if (reference_pose_covariance_topic.empty() == false)
+		reference_pose_covariance_sub_ = node_handle_.subscribe(reference_pose_covariance_topic, 1, &CameraBaseCalibrationMarker::referencePoseCovarianceCallback, this);
 
 	// initial parameters
 	bool success = transform_utilities::getTransform(transform_listener_, base_frame_, torso_lower_frame_, T_base_to_torso_lower_);
@@ -218,17 +238,53 @@ CameraBaseCalibrationMarker::CameraBaseCalibrationMarker(ros::NodeHandle nh) :
 		throw std::exception();
 	}
 
+	// the base controller reads the robot pose from a background feed, so it never blocks on TF
+	reference_pose_feed_ = new ReferencePoseFeed(transform_listener_, child_frame_name_, base_frame_, reference_pose_feed_rate, ros::Duration(reference_pose_max_age));
+	reference_pose_feed_->setStaleCallback(boost::bind(&CameraBaseCalibrationMarker::stopBaseOnStalePose, this));
+	reference_pose_feed_->start();
+
 	std::cout << "CameraBaseCalibrationMarker: init done." << std::endl;
 }
 
 CameraBaseCalibrationMarker::~CameraBaseCalibrationMarker()
 {
+	if (reference_pose_feed_ != 0)
+		delete reference_pose_feed_;
+}
+
+void CameraBaseCalibrationMarker::stopBaseOnStalePose()
+{
+	if (base_in_motion_.load() == true)
+	{
+		ROS_WARN("Reference frame is outdated, stopping the robot base.");
+		turnOffBaseMotion();
+	}
+}
+
+void CameraBaseCalibrationMarker::referencePoseCovarianceCallback(const geometry_msgs::PoseWithCovarianceStamped::ConstPtr& msg)
+{
+	// x, y and yaw variances from the 6x6 row-major covariance (x, y, z, roll, pitch, yaw)
+	ReferencePoseCovariance covariance;
+	covariance.variance_x_ = msg->pose.covariance[0];
+	covariance.variance_y_ = msg->pose.covariance[7];
+	covariance.variance_yaw_ = msg->pose.covariance[35];
+	covariance.stamp_ = msg->header.stamp;
+	reference_pose_covariance_.write(covariance);
 }
 
 bool CameraBaseCalibrationMarker::isReferenceFrameValid(cv::Mat &T) // Safety measure, to avoid undetermined motion
 {
-	if (!transform_utilities::getTransform(transform_listener_, child_frame_name_, base_frame_, T))
+	ros::Duration age;
+	if (reference_pose_feed_ == 0 || reference_pose_feed_->getLatestPose(T, age) == false)
+	{
+		ROS_WARN("Reference frame has not been received yet.");
+		return false;
+	}
+	if (age > reference_pose_feed_->getMaxAge())
+	{
+		ROS_WARN("Reference frame is outdated by %f s.", age.toSec());
 		return false;
+	}
 
 	double currentSqNorm = T.at<double>(0,3)*T.at<double>(0,3) + T.at<double>(1,3)*T.at<double>(1,3) + T.at<double>(2,3)*T.at<double>(2,3);
 
@@ -239,6 +295,20 @@ bool CameraBaseCalibrationMarker::isReferenceFrameValid(cv::Mat &T) // Safety me
 
 	RefFrameHistory_[ RefHistoryIndex_ < RefFrameHistorySize-1 ? RefHistoryIndex_++ : (RefHistoryIndex_ = 0) ] = currentSqNorm; // Update with new measurement
 
+	// if the localization publishes the uncertainty of the reference frame, gate on it instead of the deviation heuristic below
+	ReferencePoseCovariance covariance;
+	if (reference_pose_covariance_.read(covariance) == true && ros::Time::now() - covariance.stamp_ <= reference_pose_feed_->getMaxAge())
+	{
+		const double position_stddev = sqrt(covariance.variance_x_ + covariance.variance_y_);
+		const double angle_stddev = sqrt(covariance.variance_yaw_);
+		if (!(position_stddev <= max_reference_position_stddev_ && angle_stddev <= max_reference_angle_stddev_))
+		{
+			ROS_WARN("Reference frame is too uncertain (position std. dev. %f m, angle std. dev. %f rad).", position_stddev, angle_stddev);
+			return false;
+		}
+		return true;
+	}
+
 	if ( average == 0.0 || abs(1.0 - (currentSqNorm/average)) > 0.15  ) // Up to 15% deviation to average is allowed.
 	{
 		ROS_WARN("Reference frame can't be detected reliably. It's current deviation to average to too great.");
@@ -250,9 +320,6 @@ bool CameraBaseCalibrationMarker::isReferenceFrameValid(cv::Mat &T) // Safety me
 
 bool CameraBaseCalibrationMarker::moveRobot(const calibration_utilities::RobotConfiguration& robot_configuration)
 {
-	const double k_base = 0.25;
-	const double k_phi = 0.25;
-	
 	//Avoid that robot moves, when there is an error with detecting the wall!
 
 	// move pan-tilt unit
@@ -289,92 +356,22 @@ bool CameraBaseCalibrationMarker::moveRobot(const calibration_utilities::RobotCo
 	//std::cout << "Before control: error_x=" << error_x << "   error_y=" << error_y << "   error_phi=" << error_phi << std::endl;
 	if (fabs(error_phi) > 0.03 || fabs(error_x) > 0.02 || fabs(error_y) > 0.02)
 	{
-		// control robot angle
-		while(true)
-		{
-			if (!isReferenceFrameValid(T))
-			{
-				turnOffBaseMotion();
-				return false;
-			}
-
-			cv::Vec3d ypr = transform_utilities::YPRFromRotationMatrix(T);
-			double robot_yaw = ypr.val[0];
-			geometry_msgs::Twist tw;
-			error_phi = robot_configuration.pose_phi_ - robot_yaw;
-			while (error_phi < -CV_PI*0.5)
-				error_phi += CV_PI;
-			while (error_phi > CV_PI*0.5)
-				error_phi -= CV_PI;
-			if (fabs(error_phi) < 0.02 || !ros::ok())
-				break;
-			tw.angular.z = std::min(0.05, k_phi*error_phi);
-			calibration_interface_->assignNewRobotVelocity(tw);
-			ros::Rate(20).sleep();
-		}
-
-		turnOffBaseMotion();
-
-		// control position
-		while(true)
-		{
-			if (!isReferenceFrameValid(T))
-			{
-				turnOffBaseMotion();
-				return false;
-			}
-
-			geometry_msgs::Twist tw;
-			error_x = robot_configuration.pose_x_ - T.at<double>(0,3);
-			error_y = robot_configuration.pose_y_ - T.at<double>(1,3);
-			if ((fabs(error_x) < 0.01 && fabs(error_y) < 0.01) || !ros::ok())
-				break;
-//			std::cout << "error_x: " << error_x << std::endl;
-//			std::cout << "error_y: " << error_y << std::endl;
-			tw.linear.x = std::min(0.05, k_base*error_x);
-			tw.linear.y = std::min(0.05, k_base*error_y);
-			calibration_interface_->assignNewRobotVelocity(tw);
-			ros::Rate(20).sleep();
-		}
-
-		turnOffBaseMotion();
-
-		// control robot angle
-		while (true)
-		{
-			if (!isReferenceFrameValid(T))
-			{
-				turnOffBaseMotion();
-				return false;
-			}
-
-			cv::Vec3d ypr = transform_utilities::YPRFromRotationMatrix(T);
-			double robot_yaw = ypr.val[0];
-			geometry_msgs::Twist tw;
-			error_phi = robot_configuration.pose_phi_ - robot_yaw;
-			while (error_phi < -CV_PI*0.5)
-				error_phi += CV_PI;
-			while (error_phi > CV_PI*0.5)
-				error_phi -= CV_PI;
-			if (fabs(error_phi) < 0.02 || !ros::ok())
-				break;
-			tw.angular.z = std::min(0.05, k_phi*error_phi);
-			calibration_interface_->assignNewRobotVelocity(tw);
-			ros::Rate(20).sleep();
-		}
-
-		// turn off robot motion
-		turnOffBaseMotion();
+		// the base is positioned by a dedicated control thread at a fixed rate, this thread keeps serving callbacks meanwhile
+		bool success = false;
+		boost::thread control_thread(boost::bind(&CameraBaseCalibrationMarker::controlBasePose, this, boost::cref(robot_configuration), boost::ref(success)));
+		while (control_thread.try_join_for(boost::chrono::milliseconds(10)) == false)
+			ros::spinOnce();
+		if (success == false)
+			return false;
 	}
 	
 	// wait for pan tilt to arrive at goal position
-	if ( (*calibration_interface_->getCurrentCameraState()).size() > 0 )//calibration_interface_->getCurrentCameraPanAngle()!=0 && calibration_interface_->getCurrentCameraTiltAngle()!=0)
+	if ( calibration_interface_->getCurrentCameraState().positions_.size() > 0 )//calibration_interface_->getCurrentCameraPanAngle()!=0 && calibration_interface_->getCurrentCameraTiltAngle()!=0)
 	{
 		Timer timeout;
 		while (timeout.getElapsedTimeInSec()<5.0)
 		{
-			boost::mutex::scoped_lock(pan_tilt_joint_state_data_mutex_);
-			std::vector<double> cur_state = *calibration_interface_->getCurrentCameraState();
+			const std::vector<double> cur_state = calibration_interface_->getCurrentCameraState().positions_;
 			std::vector<double> difference(cur_state.size());
 			for (int i = 0; i<cur_state.size(); ++i)
 				difference[i] = angles.data[i]-cur_state[i];
@@ -406,6 +403,105 @@ bool CameraBaseCalibrationMarker::moveRobot(const calibration_utilities::RobotCo
 	return true;
 }
 
+void CameraBaseCalibrationMarker::controlBasePose(const calibration_utilities::RobotConfiguration& robot_configuration, bool& success)
+{
+	const double k_base = 0.25;
+	const double k_phi = 0.25;
+	double error_phi = 10;
+	double error_x = 10;
+	double error_y = 10;
+	cv::Mat T;
+	success = false;
+
+	FixedRateLoop control_loop(base_control_rate_);
+
+	// control robot angle
+	while(true)
+	{
+		if (!isReferenceFrameValid(T))
+		{
+			turnOffBaseMotion();
+			control_loop.printStatistics("Base control");
+			return;
+		}
+
+		cv::Vec3d ypr = transform_utilities::YPRFromRotationMatrix(T);
+		double robot_yaw = ypr.val[0];
+		geometry_msgs::Twist tw;
+		error_phi = robot_configuration.pose_phi_ - robot_yaw;
+		while (error_phi < -CV_PI*0.5)
+			error_phi += CV_PI;
+		while (error_phi > CV_PI*0.5)
+			error_phi -= CV_PI;
+		if (fabs(error_phi) < 0.02 || !ros::ok())
+			break;
+		tw.angular.z = std::min(0.05, k_phi*error_phi);
+		base_in_motion_ = true;
+		calibration_interface_->assignNewRobotVelocity(tw);
+		control_loop.sleep();
+	}
+
+	turnOffBaseMotion();
+
+	// control position
+	while(true)
+	{
+		if (!isReferenceFrameValid(T))
+		{
+			turnOffBaseMotion();
+			control_loop.printStatistics("Base control");
+			return;
+		}
+
+		geometry_msgs::Twist tw;
+		error_x = robot_configuration.pose_x_ - T.at<double>(0,3);
+		error_y = robot_configuration.pose_y_ - T.at<double>(1,3);
+		if ((fabs(error_x) < 0.01 && fabs(error_y) < 0.01) || !ros::ok())
+			break;
+//			std::cout << "error_x: " << error_x << std::endl;
+//			std::cout << "error_y: " << error_y << std::endl;
+		tw.linear.x = std::min(0.05, k_base*error_x);
+		tw.linear.y = std::min(0.05, k_base*error_y);
+		base_in_motion_ = true;
+		calibration_interface_->assignNewRobotVelocity(tw);
+		control_loop.sleep();
+	}
+
+	turnOffBaseMotion();
+
+	// control robot angle
+	while (true)
+	{
+		if (!isReferenceFrameValid(T))
+		{
+			turnOffBaseMotion();
+			control_loop.printStatistics("Base control");
+			return;
+		}
+
+		cv::Vec3d ypr = transform_utilities::YPRFromRotationMatrix(T);
+		double robot_yaw = ypr.val[0];
+		geometry_msgs::Twist tw;
+		error_phi = robot_configuration.pose_phi_ - robot_yaw;
+		while (error_phi < -CV_PI*0.5)
+			error_phi += CV_PI;
+		while (error_phi > CV_PI*0.5)
+			error_phi -= CV_PI;
+		if (fabs(error_phi) < 0.02 || !ros::ok())
+			break;
+		tw.angular.z = std::min(0.05, k_phi*error_phi);
+		base_in_motion_ = true;
+		calibration_interface_->assignNewRobotVelocity(tw);
+		control_loop.sleep();
+	}
+
+	// turn off robot motion
+	turnOffBaseMotion();
+
+	control_loop.printStatistics("Base control");
+	success = true;
+}
+
 void CameraBaseCalibrationMarker::turnOffBaseMotion()
 {
 	geometry_msgs::Twist tw;
@@ -413,69 +509,23 @@ void CameraBaseCalibrationMarker::turnOffBaseMotion()
 	tw.linear.y = 0;
 	tw.angular.z = 0;
 	calibration_interface_->assignNewRobotVelocity(tw);
+	base_in_motion_ = false;
 }
 
 void CameraBaseCalibrationMarker::extrinsicCalibrationBaseToTorsoLower(std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
 		std::vector<cv::Mat>& T_base_to_marker_vector, std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector,
 		std::vector<cv::Mat>& T_camera_to_marker_vector)
 {
-	// transform 3d chessboard points to respective coordinates systems (base and torso_lower)
-	std::vector<cv::Point3d> points_3d_base, points_3d_torso_lower;
-	for (size_t i=0; i<pattern_points_3d.size(); ++i)
-	{
-		cv::Mat T_torso_lower_to_marker = T_torso_lower_to_torso_upper_vector[i] * T_torso_upper_to_camera_ * T_camera_to_marker_vector[i];
-//		std::cout << "T_base_to_marker_vector[" << i << "]:\n" << T_base_to_marker_vector[i] << std::endl;
-//		std::cout << "T_torso_lower_to_marker:\n" << T_torso_lower_to_marker << std::endl;
-//		std::cout << "T_torso_lower_to_torso_upper_vector[i]:\n" << T_torso_lower_to_torso_upper_vector[i] << std::endl;
-//		std::cout << "T_torso_upper_to_camera_:\n" << T_torso_upper_to_camera_ << std::endl;
-//		std::cout << "T_camera_to_marker_vector[i]:\n" << T_camera_to_marker_vector[i] << std::endl;
-		for (size_t j=0; j<pattern_points_3d[i].size(); ++j)
-		{
-			cv::Mat point = cv::Mat(cv::Vec4d(pattern_points_3d[i][j].x, pattern_points_3d[i][j].y, pattern_points_3d[i][j].z, 1.0));
-
-			// to base coordinate system
-			cv::Mat point_base = T_base_to_marker_vector[i] * point;
-			//std::cout << "point_base: " << pattern_points_3d[i][j].x <<", "<< pattern_points_3d[i][j].y <<", "<< pattern_points_3d[i][j].z << " --> " << point_base.at<double>(0,0) <<", "<< point_base.at<double>(1,0) << ", " << point_base.at<double>(2,0) << std::endl;
-			points_3d_base.push_back(cv::Point3d(point_base.at<double>(0), point_base.at<double>(1), point_base.at<double>(2)));
-
-			// to torso_lower coordinate
-			cv::Mat point_torso_lower = T_torso_lower_to_marker * point;
-			//std::cout << "point_torso_lower: " << pattern_points_3d[i][j].x <<", "<< pattern_points_3d[i][j].y <<", "<< pattern_points_3d[i][j].z << " --> " << point_torso_lower.at<double>(0) <<", "<< point_torso_lower.at<double>(1) << ", " << point_torso_lower.at<double>(2) << std::endl;
-			points_3d_torso_lower.push_back(cv::Point3d(point_torso_lower.at<double>(0), point_torso_lower.at<double>(1), point_torso_lower.at<double>(2)));
-		}
-	}
-
-	T_base_to_torso_lower_ = transform_utilities::computeExtrinsicTransform(points_3d_base, points_3d_torso_lower);
+	T_base_to_torso_lower_ = extrinsic_solver::estimateBaseToTorsoLower(pattern_points_3d, T_base_to_marker_vector, T_torso_lower_to_torso_upper_vector,
+			T_camera_to_marker_vector, T_torso_upper_to_camera_);
 }
 
 void CameraBaseCalibrationMarker::extrinsicCalibrationTorsoUpperToCamera(std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
 		std::vector<cv::Mat>& T_base_to_marker_vector, std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector,
 		std::vector<cv::Mat>& T_camera_to_marker_vector)
 {
-	// transform 3d marker points to respective coordinates systems (camera and torso_upper)
-	std::vector<cv::Point3d> points_3d_torso_upper, points_3d_camera;
-	for (size_t i=0; i<pattern_points_3d.size(); ++i)
-	{
-		cv::Mat T_torso_upper_to_marker = T_torso_lower_to_torso_upper_vector[i].inv() * T_base_to_torso_lower_.inv() * T_base_to_marker_vector[i];
-//		std::cout << "T_camera_to_marker_vector[i]:\n" << T_camera_to_marker_vector[i] << std::endl;
-//		std::cout << "T_torso_upper_to_marker:\n" << T_torso_upper_to_marker << std::endl;
-		for (size_t j=0; j<pattern_points_3d[i].size(); ++j)
-		{
-			cv::Mat point = cv::Mat(cv::Vec4d(pattern_points_3d[i][j].x, pattern_points_3d[i][j].y, pattern_points_3d[i][j].z, 1.0));
-
-			// to camera coordinate system
-			cv::Mat point_camera = T_camera_to_marker_vector[i] * point;
-			//std::cout << "point_camera=" << point_camera << std::endl;
-			points_3d_camera.push_back(cv::Point3d(point_camera.at<double>(0), point_camera.at<double>(1), point_camera.at<double>(2)));
-
-			// to torso_upper coordinate
-			cv::Mat point_torso_upper = T_torso_upper_to_marker * point;
-			//std::cout << "point_torso_upper=" << point_torso_upper << std::endl;
-			points_3d_torso_upper.push_back(cv::Point3d(point_torso_upper.at<double>(0), point_torso_upper.at<double>(1), point_torso_upper.at<double>(2)));
-		}
-	}
-
-	T_torso_upper_to_camera_ = transform_utilities::computeExtrinsicTransform(points_3d_torso_upper, points_3d_camera);
+	T_torso_upper_to_camera_ = extrinsic_solver::estimateTorsoUpperToCamera(pattern_points_3d, T_base_to_marker_vector, T_torso_lower_to_torso_upper_vector,
+			T_camera_to_marker_vector, T_base_to_torso_lower_);
 }
 
 void CameraBaseCalibrationMarker::extrinsicCalibration(std::vector< std::vector<cv::Point3f> >& pattern_points_3d,
@@ -50,6 +50,7 @@
 
 #include <robotino_calibration/camera_base_calibration_pitag.h>
 #include <robotino_calibration/transformation_utilities.h>
+#include <robotino_calibration/extrinsic_solver.h>
 
 #include <std_msgs/Float64.h>
 
@@ -57,12 +58,14 @@
 #include <pcl/registration/icp.h>
 
 #include <sstream>
+#include <boost/bind.hpp>
 
 #include <cob_object_detection_msgs/DetectObjects.h>
+#include <ros/package.h>
 
 
 CameraBaseCalibrationPiTag::CameraBaseCalibrationPiTag(ros::NodeHandle nh) :
-			CameraBaseCalibrationMarker(nh)
+			CameraBaseCalibrationMarker(nh), pitag_detector_(0)
 {
 	// load parameters
 	std::cout << "\n========== CameraBaseCalibrationPiTag Parameters ==========\n";
@@ -70,15 +73,76 @@ CameraBaseCalibrationPiTag::CameraBaseCalibrationPiTag(ros::NodeHandle nh) :
 	std::cout << "marker_frame_base_name: " << marker_frame_base_name_ << std::endl;
 	node_handle_.param<std::string>("get_fiducials_topic", get_fiducials_topic_, "/fiducials/get_fiducials");
 	std::cout << "get_fiducials_topic: " << get_fiducials_topic_ << std::endl;
-
-
-	pitag_client_ = node_handle_.serviceClient<cob_object_detection_msgs::DetectObjects>(get_fiducials_topic_);
+	node_handle_.param("active_view_selection", active_view_selection_, false);
+	std::cout << "active_view_selection: " << active_view_selection_ << std::endl;
+	node_handle_.param("view_selection_max_std_rotation", view_selection_max_std_rotation_, 0.005);
+	std::cout << "view_selection_max_std_rotation: " << view_selection_max_std_rotation_ << std::endl;
+	node_handle_.param("view_selection_max_std_translation", view_selection_max_std_translation_, 0.002);
+	std::cout << "view_selection_max_std_translation: " << view_selection_max_std_translation_ << std::endl;
+	node_handle_.param("view_selection_prior_std_rotation", view_selection_prior_std_rotation_, 0.1);
+	std::cout << "view_selection_prior_std_rotation: " << view_selection_prior_std_rotation_ << std::endl;
+	node_handle_.param("view_selection_prior_std_translation", view_selection_prior_std_translation_, 0.05);
+	std::cout << "view_selection_prior_std_translation: " << view_selection_prior_std_translation_ << std::endl;
+	node_handle_.param("view_selection_measurement_std", view_selection_measurement_std_, 0.01);
+	std::cout << "view_selection_measurement_std: " << view_selection_measurement_std_ << std::endl;
+	node_handle_.param("view_selection_travel_cost_weight", view_selection_travel_cost_weight_, 1.0);
+	std::cout << "view_selection_travel_cost_weight: " << view_selection_travel_cost_weight_ << std::endl;
+	node_handle_.param("view_selection_field_of_view", view_selection_field_of_view_, 0.5);
+	std::cout << "view_selection_field_of_view: " << view_selection_field_of_view_ << std::endl;
+	node_handle_.param("view_selection_min_views", view_selection_min_views_, 3);
+	std::cout << "view_selection_min_views: " << view_selection_min_views_ << std::endl;
+	node_handle_.param("view_selection_optimization_iterations", view_selection_optimization_iterations_, 2);
+	std::cout << "view_selection_optimization_iterations: " << view_selection_optimization_iterations_ << std::endl;
+
+
+	node_handle_.param("pitag_in_process_detection", pitag_in_process_detection_, false);
+	std::cout << "pitag_in_process_detection: " << pitag_in_process_detection_ << std::endl;
+	node_handle_.param("pitag_detection_passes", pitag_detection_passes_, 1);
+	std::cout << "pitag_detection_passes: " << pitag_detection_passes_ << std::endl;
+	std::string camera_image_topic, camera_info_topic, pitag_model_file;
+	node_handle_.param<std::string>("camera_image_topic", camera_image_topic, "/kinect/rgb/image_raw");
+	std::cout << "camera_image_topic: " << camera_image_topic << std::endl;
+	node_handle_.param<std::string>("camera_info_topic", camera_info_topic, "/kinect/rgb/camera_info");
+	std::cout << "camera_info_topic: " << camera_info_topic << std::endl;
+	node_handle_.param<std::string>("pitag_model_file", pitag_model_file, ros::package::getPath("robotino_calibration") + "/ros/launch/pi_tag/piTagIni_0.xml");
+	std::cout << "pitag_model_file: " << pitag_model_file << std::endl;
+
+
+	// Pi tags are either detected within this node or by a separate cob_fiducials node
+	if (pitag_in_process_detection_ == true)
+		pitag_detector_ = new PiTagDetector(node_handle_, camera_image_topic, camera_info_topic, pitag_model_file);
+	else
+		pitag_client_ = node_handle_.serviceClient<cob_object_detection_msgs::DetectObjects>(get_fiducials_topic_);
 
 	ROS_INFO("CameraBaseCalibrationPiTag initialized.");
 }
 
 CameraBaseCalibrationPiTag::~CameraBaseCalibrationPiTag()
 {
+	if (pitag_detector_ != 0)
+		delete pitag_detector_;
+}
+
+bool CameraBaseCalibrationPiTag::detectMarkers(cob_object_detection_msgs::DetectionArray& detection_array)
+{
+	if (pitag_detector_ != 0)
+	{
+		// only images taken after the camera has settled are considered
+		if (pitag_detector_->detect(ros::Time::now(), pitag_detection_passes_, ros::Duration(5.0), detection_array) == false)
+			return false;
+	}
+	else
+	{
+		cob_object_detection_msgs::DetectObjects detect;
+		if (pitag_client_.call(detect) == false)
+		{
+			ROS_WARN("Could not call the Pi tag detection service %s.", get_fiducials_topic_.c_str());
+			return false;
+		}
+		detection_array = detect.response.object_list;
+	}
+
+	return (detection_array.detections.size() > 0);
 }
 
 bool CameraBaseCalibrationPiTag::calibrateCameraToBase(const bool load_data)
@@ -178,22 +242,22 @@ bool CameraBaseCalibrationPiTag::acquireCalibrationDataNEW(const std::vector<cal
 			ros::Duration(3).sleep();
 
 			// extract marker points
-			cob_object_detection_msgs::DetectObjects detect;
-			pitag_client_.call(detect);
-			if (detect.response.object_list.detections.size() == 0)
+			cob_object_detection_msgs::DetectionArray detection_array;
+			if (detectMarkers(detection_array) == false)
 				continue;
 
-			for (size_t detection=0; detection<detect.response.object_list.detections.size(); ++detection)
+			for (size_t detection=0; detection<detection_array.detections.size(); ++detection)
 			{
-				cob_object_detection_msgs::Detection& det = detect.response.object_list.detections[detection];
+				cob_object_detection_msgs::Detection& det = detection_array.detections[detection];
 				std::string marker_frame = marker_frame_base_name_ + det.label.substr(3);	// yields e.g. "tag_18"
 
 				// retrieve transformations
 				cv::Mat T_base_to_marker, T_camera_to_camera_optical, T_camera_optical_to_marker, T_camera_to_marker;
 				std::vector<cv::Mat> T_between_gaps;
 				bool result = true;
-				result &= transform_utilities::getTransform(transform_listener_, base_frame_, marker_frame, T_base_to_marker);
-				result &= transform_utilities::getTransform(transform_listener_, camera_frame_, camera_optical_frame_, T_camera_to_camera_optical);
+				const ros::Time& stamp = det.pose.header.stamp;
+				result &= transform_utilities::getTransform(transform_listener_, base_frame_, marker_frame, stamp, transform_lookup_timeout_, T_base_to_marker);
+				result &= static_transform_cache_.getTransform(camera_frame_, camera_optical_frame_, stamp, transform_lookup_timeout_, T_camera_to_camera_optical);
 
 				for ( int i=0; i<transforms_to_calibrate_.size()-1; ++i )
 				{
@@ -201,7 +265,7 @@ bool CameraBaseCalibrationPiTag::acquireCalibrationDataNEW(const std::vector<cal
 						continue;
 
 					cv::Mat temp;
-					result &= transform_utilities::getTransform(transform_listener_, transforms_to_calibrate_[i].child_, transforms_to_calibrate_[i+1].parent_, temp);
+					result &= transform_utilities::getTransform(transform_listener_, transforms_to_calibrate_[i].child_, transforms_to_calibrate_[i+1].parent_, stamp, transform_lookup_timeout_, temp);
 					T_between_gaps.push_back(temp);
 					transforms_to_calibrate_[i].trafo_until_next_gap_idx_ = T_between_gaps.size()-1;
 				}
@@ -270,98 +334,228 @@ bool CameraBaseCalibrationPiTag::acquireCalibrationData(const std::vector<calibr
 		const bool load_data, std::vector<cv::Mat>& T_base_to_marker_vector,
 		std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector, std::vector<cv::Mat>& T_camera_to_marker_vector)
 {
-	std::stringstream path;
-	path << calibration_storage_path_ << "pitag_data.yml";
+	const std::string archive_path = calibration_storage_path_ + "session_archive.bin";
 
 	// capture images from different perspectives
 	if (load_data == false)
 	{
 		const int number_images_to_capture = (int)robot_configurations.size();
-		for (int image_counter = 0; image_counter < number_images_to_capture; ++image_counter)
+
+		// state of the active view selection: parameters are the rotations and translations of T_base_to_torso_lower_ and T_torso_upper_to_camera_
+		std::vector<double> prior_std, max_std;
+		for (int t=0; t<2; ++t)
+		{
+			prior_std.insert(prior_std.end(), 3, view_selection_prior_std_rotation_);
+			prior_std.insert(prior_std.end(), 3, view_selection_prior_std_translation_);
+			max_std.insert(max_std.end(), 3, view_selection_max_std_rotation_);
+			max_std.insert(max_std.end(), 3, view_selection_max_std_translation_);
+		}
+		ViewSelection view_selection(prior_std, view_selection_measurement_std_);
+		view_selection_T_base_to_torso_lower_ = T_base_to_torso_lower_.clone();
+		view_selection_T_torso_upper_to_camera_ = T_torso_upper_to_camera_.clone();
+		std::vector<bool> visited(number_images_to_capture, false);
+		std::vector<cv::Mat> T_torso_lower_to_torso_upper_per_configuration(number_images_to_capture);
+		std::map<std::string, cv::Mat> marker_points_reference;		// latest position of each seen marker in the reference frame
+		cv::Mat T_reference_to_base_last, T_camera_to_camera_optical_last;
+		int configuration_index = -1;
+
+		// views of an interrupted session are restored from their checkpoint files before the motion plan is continued
+		AcquisitionCheckpoint checkpoint(calibration_storage_path_ + "acquisition_checkpoint.txt", number_images_to_capture,
+				AcquisitionCheckpoint::describeSession("pitag", robot_configurations));
+		startAcquisitionSession(checkpoint);
+		SessionArchiveWriter archive_writer;
+		archive_writer.open(archive_path, checkpoint.getCapturedCount() > 0);
+		SessionArchiveReader archive_reader;
+		if (checkpoint.getCapturedCount() > 0)
+			archive_reader.open(archive_path);
+		std::vector<int> restored_configurations;
+		for (int i=0; i<number_images_to_capture; ++i)
+			if (checkpoint.isCaptured(i))
+				restored_configurations.push_back(i);
+		size_t restored_count = 0;
+
+		// detection needs the current camera image and is part of the capture stage, saving runs while the robot moves on
+		AcquisitionPipeline pipeline(acquisition_worker_threads_, acquisition_queue_size_);
+
+		for (int view_counter = 0; ; ++view_counter)
 		{
 			if ( !ros::ok() )
 				return false;
 
-			std::cout << "Configuration " << (image_counter+1) << "/" << number_images_to_capture << std::endl;
+			PiTagView view;
+			const bool restoring = (restored_count < restored_configurations.size());
+			if (restoring)
+			{
+				configuration_index = restored_configurations[restored_count++];
+				if (loadView(archive_reader, configuration_index, view) == false)
+					continue;
+				std::cout << "Configuration " << (configuration_index+1) << "/" << number_images_to_capture << " restored from checkpoint" << std::endl;
+			}
+			else
+			{
+				if (active_view_selection_)
+				{
+					configuration_index = selectNextConfiguration(robot_configurations, visited, configuration_index, view_selection,
+							T_torso_lower_to_torso_upper_per_configuration, marker_points_reference, T_reference_to_base_last, T_camera_to_camera_optical_last);
+				}
+				else
+				{
+					// continue the motion plan with the first configuration that has not been visited yet
+					configuration_index = -1;
+					for (int i=0; i<number_images_to_capture && configuration_index<0; ++i)
+						if (!visited[i])
+							configuration_index = i;
+				}
+				if (configuration_index < 0)
+					break;
 
-			moveRobot(robot_configurations[image_counter]);
-			// wait a moment here to mitigate shaking camera effects?
+				std::cout << "Configuration " << (configuration_index+1) << "/" << number_images_to_capture << " (view " << (view_counter+1) << ")" << std::endl;
+			}
+			visited[configuration_index] = true;
 
-			ros::Duration(3).sleep();
+			if (!restoring)
+			{
+				Timer move_time;
+				moveRobot(robot_configurations[configuration_index]);
+				pipeline.addStageTime(AcquisitionPipeline::STAGE_MOVE, move_time.getElapsedTimeInSec());
+				// wait a moment here to mitigate shaking camera effects?
 
-			// NOT necessary, apparently the results are good enough and simulated tests show that the influence of little shaking can be compensated by enough data
+				Timer capture_time;
+				ros::Duration(3).sleep();
 
-			// extract marker points
-			cob_object_detection_msgs::DetectObjects detect;
-			pitag_client_.call(detect);
-			if (detect.response.object_list.detections.size() == 0)
-				continue;
+				// NOT necessary, apparently the results are good enough and simulated tests show that the influence of little shaking can be compensated by enough data
 
-			for (size_t detection=0; detection<detect.response.object_list.detections.size(); ++detection)
-			{
-				cob_object_detection_msgs::Detection& det = detect.response.object_list.detections[detection];
-				std::string marker_frame = marker_frame_base_name_ + det.label.substr(3);	// yields e.g. "tag_18"
+				// extract marker points
+				cob_object_detection_msgs::DetectionArray detection_array;
+				if (detectMarkers(detection_array) == false)
+					continue;
 
-				// retrieve transformations
-				cv::Mat T_base_to_marker, T_torso_lower_to_torso_upper, T_camera_to_camera_optical, T_camera_optical_to_marker, T_camera_to_marker;
-				bool result = true;
-				result &= transform_utilities::getTransform(transform_listener_, base_frame_, marker_frame, T_base_to_marker);
-				result &= transform_utilities::getTransform(transform_listener_, torso_lower_frame_, torso_upper_frame_, T_torso_lower_to_torso_upper);
-				result &= transform_utilities::getTransform(transform_listener_, camera_frame_, camera_optical_frame_, T_camera_to_camera_optical);
-				if (result == false)
+				// the robot pose in the reference frame is needed to predict marker observations from other configurations
+				transform_utilities::getTransform(transform_listener_, child_frame_name_, base_frame_, detection_array.detections[0].pose.header.stamp,
+						transform_lookup_timeout_, view.T_reference_to_base_);
+
+				for (size_t detection=0; detection<detection_array.detections.size(); ++detection)
+				{
+					cob_object_detection_msgs::Detection& det = detection_array.detections[detection];
+					std::string marker_frame = marker_frame_base_name_ + det.label.substr(3);	// yields e.g. "tag_18"
+
+					// retrieve transformations at the time of the detection
+					std::vector<transform_utilities::FramePair> frame_pairs;
+					frame_pairs.push_back(transform_utilities::FramePair(base_frame_, marker_frame));
+					frame_pairs.push_back(transform_utilities::FramePair(torso_lower_frame_, torso_upper_frame_));
+					std::vector<cv::Mat> transforms;
+					cv::Mat T_camera_to_camera_optical;
+					if (transform_utilities::getTransforms(transform_listener_, frame_pairs, det.pose.header.stamp, transform_lookup_timeout_, transforms) == false ||
+							static_transform_cache_.getTransform(camera_frame_, camera_optical_frame_, det.pose.header.stamp, transform_lookup_timeout_, T_camera_to_camera_optical) == false)
+						continue;
+					cv::Mat T_base_to_marker = transforms[0], T_torso_lower_to_torso_upper = transforms[1];
+					cv::Mat T_camera_optical_to_marker, T_camera_to_marker;
+					tf::Stamped<tf::Pose> pose;
+					tf::poseStampedMsgToTF(det.pose, pose);
+					const tf::Matrix3x3& rot = pose.getBasis();
+					const tf::Vector3& trans = pose.getOrigin();
+					cv::Mat rotcv(3,3,CV_64FC1);
+					cv::Mat transcv(3,1,CV_64FC1);
+					for (int v=0; v<3; ++v)
+						for (int u=0; u<3; ++u)
+							rotcv.at<double>(v,u) = rot[v].m_floats[u];
+					for (int v=0; v<3; ++v)
+						transcv.at<double>(v) = trans.m_floats[v];
+					T_camera_optical_to_marker = transform_utilities::makeTransform(rotcv, transcv);
+					T_camera_to_marker = T_camera_to_camera_optical*T_camera_optical_to_marker;
+
+					// attach data to view
+					view.marker_frames_.push_back(marker_frame);
+					view.T_base_to_marker_vector_.push_back(T_base_to_marker);
+					view.T_torso_lower_to_torso_upper_vector_.push_back(T_torso_lower_to_torso_upper);
+					view.T_camera_to_marker_vector_.push_back(T_camera_to_marker);
+					view.T_camera_to_camera_optical_ = T_camera_to_camera_optical;
+
+					ROS_INFO("=#=#=#=#=#=#=#=#= Found %s", marker_frame.c_str());
+				}
+
+				pipeline.addStageTime(AcquisitionPipeline::STAGE_CAPTURE, capture_time.getElapsedTimeInSec());
+				if (view.marker_frames_.size() == 0)
 					continue;
-				tf::Stamped<tf::Pose> pose;
-				tf::poseStampedMsgToTF(det.pose, pose);
-				const tf::Matrix3x3& rot = pose.getBasis();
-				const tf::Vector3& trans = pose.getOrigin();
-				cv::Mat rotcv(3,3,CV_64FC1);
-				cv::Mat transcv(3,1,CV_64FC1);
-				for (int v=0; v<3; ++v)
-					for (int u=0; u<3; ++u)
-						rotcv.at<double>(v,u) = rot[v].m_floats[u];
-				for (int v=0; v<3; ++v)
-					transcv.at<double>(v) = trans.m_floats[v];
-				T_camera_optical_to_marker = transform_utilities::makeTransform(rotcv, transcv);
-				T_camera_to_marker = T_camera_to_camera_optical*T_camera_optical_to_marker;
 
-				// attach data to array
-				T_base_to_marker_vector.push_back(T_base_to_marker);
-				T_torso_lower_to_torso_upper_vector.push_back(T_torso_lower_to_torso_upper);
-				T_camera_to_marker_vector.push_back(T_camera_to_marker);
+				pipeline.enqueue(boost::bind(&CameraBaseCalibrationPiTag::processView, this, configuration_index, view, boost::ref(archive_writer), boost::ref(checkpoint)));
+			}
 
-				ROS_INFO("=#=#=#=#=#=#=#=#= Found %s", marker_frame.c_str());
+			// attach data to array
+			for (size_t i=0; i<view.marker_frames_.size(); ++i)
+			{
+				T_base_to_marker_vector.push_back(view.T_base_to_marker_vector_[i]);
+				T_torso_lower_to_torso_upper_vector.push_back(view.T_torso_lower_to_torso_upper_vector_[i]);
+				T_camera_to_marker_vector.push_back(view.T_camera_to_marker_vector_[i]);
+
+				if (active_view_selection_)
+				{
+					T_torso_lower_to_torso_upper_per_configuration[configuration_index] = view.T_torso_lower_to_torso_upper_vector_[i];
+					if (!view.T_reference_to_base_.empty())
+						marker_points_reference[view.marker_frames_[i]] = view.T_reference_to_base_ * view.T_base_to_marker_vector_[i].col(3);
+				}
 			}
-		}
+			if (!view.T_reference_to_base_.empty())
+				T_reference_to_base_last = view.T_reference_to_base_;
+			if (!view.T_camera_to_camera_optical_.empty())
+				T_camera_to_camera_optical_last = view.T_camera_to_camera_optical_;
 
-		// save transforms to file
-		cv::FileStorage fs(path.str().c_str(), cv::FileStorage::WRITE);
-		if (fs.isOpened())
-		{
-			fs << "T_base_to_marker_vector" << T_base_to_marker_vector;
-			fs << "T_torso_lower_to_torso_upper_vector" << T_torso_lower_to_torso_upper_vector;
-			fs << "T_camera_to_marker_vector" << T_camera_to_marker_vector;
-		}
-		else
-		{
-			ROS_WARN("Could not write transformations to file '%s'.", path.str().c_str());
+			// while restoring, the estimate is only updated after the last restored view
+			if (active_view_selection_ && restored_count >= restored_configurations.size())
+			{
+				updateViewSelection(view_selection, T_base_to_marker_vector, T_torso_lower_to_torso_upper_vector, T_camera_to_marker_vector);
+
+				const std::vector<double> std_dev = view_selection.getStandardDeviations();
+				std::cout << "Standard deviations (rotation, translation):";
+				for (size_t i=0; i<std_dev.size(); ++i)
+					std::cout << " " << std_dev[i];
+				std::cout << std::endl;
+
+				if (view_counter+1 >= view_selection_min_views_ && view_selection.isConverged(max_std))
+				{
+					std::cout << "Uncertainty thresholds reached after " << (view_counter+1) << " of " << number_images_to_capture << " configurations, stopping acquisition." << std::endl;
+					break;
+				}
+			}
 		}
-		fs.release();
+
+		pipeline.waitUntilIdle();
+		pipeline.printStatistics();
 	}
 	else
 	{
-		// load data from file
-		cv::FileStorage fs(path.str().c_str(), cv::FileStorage::READ);
-		if (fs.isOpened())
+		// load data from the session archive, sessions recorded before the archive existed are read from pitag_data.yml
+		SessionArchiveReader archive_reader;
+		if (archive_reader.open(archive_path))
 		{
-			fs["T_base_to_marker_vector"] >> T_base_to_marker_vector;
-			fs["T_torso_lower_to_torso_upper_vector"] >> T_torso_lower_to_torso_upper_vector;
-			fs["T_camera_to_marker_vector"] >> T_camera_to_marker_vector;
+			const std::vector<int> view_indices = archive_reader.getViewIndices();
+			for (size_t v=0; v<view_indices.size(); ++v)
+			{
+				PiTagView view;
+				if (loadView(archive_reader, view_indices[v], view) == false)
+					continue;
+				T_base_to_marker_vector.insert(T_base_to_marker_vector.end(), view.T_base_to_marker_vector_.begin(), view.T_base_to_marker_vector_.end());
+				T_torso_lower_to_torso_upper_vector.insert(T_torso_lower_to_torso_upper_vector.end(), view.T_torso_lower_to_torso_upper_vector_.begin(), view.T_torso_lower_to_torso_upper_vector_.end());
+				T_camera_to_marker_vector.insert(T_camera_to_marker_vector.end(), view.T_camera_to_marker_vector_.begin(), view.T_camera_to_marker_vector_.end());
+			}
 		}
 		else
 		{
-			ROS_WARN("Could not read transformations from file '%s'.", path.str().c_str());
+			std::stringstream path;
+			path << calibration_storage_path_ << "pitag_data.yml";
+			cv::FileStorage fs(path.str().c_str(), cv::FileStorage::READ);
+			if (fs.isOpened())
+			{
+				fs["T_base_to_marker_vector"] >> T_base_to_marker_vector;
+				fs["T_torso_lower_to_torso_upper_vector"] >> T_torso_lower_to_torso_upper_vector;
+				fs["T_camera_to_marker_vector"] >> T_camera_to_marker_vector;
+			}
+			else
+			{
+				ROS_WARN("Could not read transformations from file '%s'.", path.str().c_str());
+			}
+			fs.release();
 		}
-		fs.release();
 
 		// some testing code for checking the influence of different error sources on the calibration results
 		// set sim=true for using this verification method
@@ -453,6 +647,177 @@ bool CameraBaseCalibrationPiTag::acquireCalibrationData(const std::vector<calibr
 	return true;
 }
 
+bool CameraBaseCalibrationPiTag::saveView(SessionArchiveWriter& archive, const int configuration_index, const PiTagView& view)
+{
+	SessionArchiveRecord record;
+	record.view_index_ = configuration_index;
+	record.labels_ = view.marker_frames_;
+	record.transforms_.push_back(view.T_reference_to_base_);
+	record.transforms_.push_back(view.T_camera_to_camera_optical_);
+	for (size_t i=0; i<view.marker_frames_.size(); ++i)
+	{
+		record.transforms_.push_back(view.T_base_to_marker_vector_[i]);
+		record.transforms_.push_back(view.T_torso_lower_to_torso_upper_vector_[i]);
+		record.transforms_.push_back(view.T_camera_to_marker_vector_[i]);
+	}
+
+	return archive.write(record);
+}
+
+void CameraBaseCalibrationPiTag::processView(const int configuration_index, const PiTagView view, SessionArchiveWriter& archive, AcquisitionCheckpoint& checkpoint)
+{
+	if (saveView(archive, configuration_index, view) == true)
+		checkpoint.markCaptured(configuration_index);
+}
+
+bool CameraBaseCalibrationPiTag::loadView(const SessionArchiveReader& archive, const int configuration_index, PiTagView& view)
+{
+	SessionArchiveRecord record;
+	if (archive.read(configuration_index, record, false) == false)
+	{
+		ROS_WARN("View %d is missing in the session archive.", configuration_index);
+		return false;
+	}
+
+	if (record.transforms_.size() != 2 + 3*record.labels_.size())
+	{
+		ROS_WARN("Inconsistent data of view %d in the session archive.", configuration_index);
+		return false;
+	}
+
+	view.marker_frames_ = record.labels_;
+	view.T_reference_to_base_ = record.transforms_[0];
+	view.T_camera_to_camera_optical_ = record.transforms_[1];
+	for (size_t i=0; i<view.marker_frames_.size(); ++i)
+	{
+		view.T_base_to_marker_vector_.push_back(record.transforms_[2+3*i]);
+		view.T_torso_lower_to_torso_upper_vector_.push_back(record.transforms_[3+3*i]);
+		view.T_camera_to_marker_vector_.push_back(record.transforms_[4+3*i]);
+	}
+
+	return true;
+}
+
+int CameraBaseCalibrationPiTag::selectNextConfiguration(const std::vector<calibration_utilities::RobotConfiguration>& robot_configurations, const std::vector<bool>& visited,
+		const int last_index, const ViewSelection& view_selection, const std::vector<cv::Mat>& T_torso_lower_to_torso_upper_per_configuration,
+		const std::map<std::string, cv::Mat>& marker_points_reference, const cv::Mat& T_reference_to_base_last, const cv::Mat& T_camera_to_camera_optical)
+{
+	const bool prediction_possible = (last_index >= 0 && !marker_points_reference.empty() && !T_reference_to_base_last.empty() && !T_camera_to_camera_optical.empty());
+
+	std::vector<cv::Mat> candidate_jacobians(robot_configurations.size());
+	std::vector<double> travel_costs(robot_configurations.size(), 0.);
+	int first_unvisited = -1;
+	for (size_t i=0; i<robot_configurations.size(); ++i)
+	{
+		if (visited[i])
+			continue;
+		if (first_unvisited < 0)
+			first_unvisited = (int)i;
+		if (!prediction_possible)
+			continue;
+
+		const calibration_utilities::RobotConfiguration& candidate = robot_configurations[i];
+
+		// the torso pose is only known for visited configurations, take the one with the closest pan and tilt angles
+		int nearest = -1;
+		double nearest_distance = 0.;
+		for (size_t j=0; j<robot_configurations.size(); ++j)
+		{
+			if (T_torso_lower_to_torso_upper_per_configuration[j].empty())
+				continue;
+			const double distance = fabs(robot_configurations[j].pan_angle_-candidate.pan_angle_) + fabs(robot_configurations[j].tilt_angle_-candidate.tilt_angle_);
+			if (nearest < 0 || distance < nearest_distance)
+			{
+				nearest = (int)j;
+				nearest_distance = distance;
+			}
+		}
+		if (nearest < 0)
+			continue;
+		const cv::Mat& T_torso_lower_to_torso_upper = T_torso_lower_to_torso_upper_per_configuration[nearest];
+
+		// commanded robot pose in the reference frame, height, roll and pitch are taken from the last measured pose
+		const cv::Vec3d ypr_last = transform_utilities::YPRFromRotationMatrix(T_reference_to_base_last);
+		const double c = cos(candidate.pose_phi_-ypr_last.val[0]), s = sin(candidate.pose_phi_-ypr_last.val[0]);
+		cv::Mat R_delta_yaw = (cv::Mat_<double>(3,3) << c, -s, 0., s, c, 0., 0., 0., 1.);
+		cv::Mat T_reference_to_base = transform_utilities::makeTransform(R_delta_yaw * T_reference_to_base_last(cv::Rect(0,0,3,3)),
+				cv::Mat(cv::Vec3d(candidate.pose_x_, candidate.pose_y_, T_reference_to_base_last.at<double>(2,3))));
+
+		const cv::Mat T_base_to_reference = T_reference_to_base.inv();
+		const cv::Mat T_camera_optical_to_base = (view_selection_T_base_to_torso_lower_ * T_torso_lower_to_torso_upper * view_selection_T_torso_upper_to_camera_ * T_camera_to_camera_optical).inv();
+
+		// predict which of the known markers are in the field of view
+		std::vector<cv::Mat> rows;
+		for (std::map<std::string, cv::Mat>::const_iterator it=marker_points_reference.begin(); it!=marker_points_reference.end(); ++it)
+		{
+			cv::Mat point_base = T_base_to_reference * it->second;
+			cv::Mat point_camera = T_camera_optical_to_base * point_base;
+			const double x = point_camera.at<double>(0), y = point_camera.at<double>(1), z = point_camera.at<double>(2);
+			if (z <= 0. || atan2(sqrt(x*x+y*y), z) > view_selection_field_of_view_)
+				continue;
+			rows.push_back(computeMarkerJacobian(T_torso_lower_to_torso_upper, point_base));
+		}
+		if (rows.size() > 0)
+			cv::vconcat(rows, candidate_jacobians[i]);
+
+		// travel cost: base translation plus base rotation, the pan-tilt unit moves while the base is driving
+		const calibration_utilities::RobotConfiguration& last = robot_configurations[last_index];
+		const double dx = candidate.pose_x_-last.pose_x_, dy = candidate.pose_y_-last.pose_y_;
+		travel_costs[i] = sqrt(dx*dx+dy*dy) + fabs(candidate.pose_phi_-last.pose_phi_);
+	}
+
+	// no candidate is expected to add information (e.g. no marker seen yet), continue in the configured order
+	const int best = view_selection.selectNextView(candidate_jacobians, travel_costs, view_selection_travel_cost_weight_);
+	return (best >= 0 ? best : first_unvisited);
+}
+
+void CameraBaseCalibrationPiTag::updateViewSelection(ViewSelection& view_selection, std::vector<cv::Mat>& T_base_to_marker_vector,
+		std::vector<cv::Mat>& T_torso_lower_to_torso_upper_vector, std::vector<cv::Mat>& T_camera_to_marker_vector)
+{
+	// the rigid transform needs at least 3 points, until then the initial estimates are kept
+	// the estimate of the previous view is refined with a few iterations only, T_base_to_torso_lower_ and T_torso_upper_to_camera_
+	// keep the initial guess of the robot description for the final calibration
+	if (T_base_to_marker_vector.size() >= 3)
+	{
+		std::vector< std::vector<cv::Point3f> > pattern_points_3d(T_base_to_marker_vector.size(), std::vector<cv::Point3f>(1, cv::Point3f(0.f, 0.f, 0.f)));
+		for (int i=0; i<view_selection_optimization_iterations_; ++i)
+		{
+			view_selection_T_base_to_torso_lower_ = extrinsic_solver::estimateBaseToTorsoLower(pattern_points_3d, T_base_to_marker_vector, T_torso_lower_to_torso_upper_vector,
+					T_camera_to_marker_vector, view_selection_T_torso_upper_to_camera_);
+			view_selection_T_torso_upper_to_camera_ = extrinsic_solver::estimateTorsoUpperToCamera(pattern_points_3d, T_base_to_marker_vector, T_torso_lower_to_torso_upper_vector,
+					T_camera_to_marker_vector, view_selection_T_base_to_torso_lower_);
+		}
+	}
+
+	// re-linearize all observations at the current estimate
+	view_selection.reset();
+	for (size_t i=0; i<T_base_to_marker_vector.size(); ++i)
+		view_selection.addObservation(computeMarkerJacobian(T_torso_lower_to_torso_upper_vector[i], T_base_to_marker_vector[i].col(3)));
+}
+
+cv::Mat CameraBaseCalibrationPiTag::computeMarkerJacobian(const cv::Mat& T_torso_lower_to_torso_upper, const cv::Mat& point_base) const
+{
+	// point in base coordinates: q = T_base_to_torso_lower * T_torso_lower_to_torso_upper * T_torso_upper_to_camera * p_camera
+	// perturbing T_base_to_torso_lower by (w1, v1) from the left yields dq = -[q]x*w1 + v1
+	// perturbing T_torso_upper_to_camera by (w2, v2) from the left yields dq = R_base_to_torso_upper * (-[y]x*w2 + v2) with y = q in torso_upper coordinates
+	const cv::Mat T_base_to_torso_upper = view_selection_T_base_to_torso_lower_ * T_torso_lower_to_torso_upper;
+	const cv::Mat R = T_base_to_torso_upper(cv::Rect(0,0,3,3));
+	cv::Mat q = point_base.rowRange(0,3);
+	cv::Mat y = T_base_to_torso_upper.inv() * point_base;
+	y = y.rowRange(0,3);
+
+	cv::Mat J = cv::Mat::zeros(3, 12, CV_64F);
+	const double qx = q.at<double>(0), qy = q.at<double>(1), qz = q.at<double>(2);
+	cv::Mat q_skew_neg = (cv::Mat_<double>(3,3) << 0., qz, -qy, -qz, 0., qx, qy, -qx, 0.);
+	const double yx = y.at<double>(0), yy = y.at<double>(1), yz = y.at<double>(2);
+	cv::Mat y_skew_neg = (cv::Mat_<double>(3,3) << 0., yz, -yy, -yz, 0., yx, yy, -yx, 0.);
+	q_skew_neg.copyTo(J(cv::Rect(0,0,3,3)));
+	cv::Mat::eye(3, 3, CV_64F).copyTo(J(cv::Rect(3,0,3,3)));
+	cv::Mat(R * y_skew_neg).copyTo(J(cv::Rect(6,0,3,3)));
+	R.copyTo(J(cv::Rect(9,0,3,3)));
+	return J;
+}
+
 bool CameraBaseCalibrationPiTag::saveCalibration()
 {
 	bool success = true;
@@ -51,18 +51,30 @@
 #include <robotino_calibration/cob_interface.h>
 
 CobInterface::CobInterface(ros::NodeHandle nh, bool bArmCalibration) :
-				CalibrationInterface(nh)
+				CalibrationInterface(nh), arm_left_state_demux_(std::vector<std::string>()), arm_right_state_demux_(std::vector<std::string>())
 {
 	std::cout << "\n========== CobInterface Parameters ==========\n";
 
 	if ( bArmCalibration )
 	{
+		node_handle_.param<std::string>("arm_to_calibrate", arm_to_calibrate_, "left");
+		std::cout << "arm_to_calibrate: " << arm_to_calibrate_ << std::endl;
+		if (arm_to_calibrate_.compare("left") != 0 && arm_to_calibrate_.compare("right") != 0)
+		{
+			ROS_WARN("CobInterface: arm_to_calibrate has to be 'left' or 'right', calibrating the left arm.");
+			arm_to_calibrate_ = "left";
+		}
+
 		node_handle_.param<std::string>("arm_left_command", arm_left_command_, "");
 		std::cout << "arm_left_command: " << arm_left_command_ << std::endl;
 		arm_left_controller_ = node_handle_.advertise<std_msgs::Float64MultiArray>(arm_left_command_, 1, false);
 
 		node_handle_.param<std::string>("arm_left_state_topic", arm_left_state_topic_, "");
 		std::cout << "arm_left_state_topic: " << arm_left_state_topic_ << std::endl;
+		std::vector<std::string> arm_left_joint_names;
+		node_handle_.getParam("arm_left_joint_names", arm_left_joint_names);
+		arm_left_state_demux_.setJointNames(arm_left_joint_names);
+		arm_left_state_current_.reserve(arm_left_joint_names.size());
 		arm_left_state_ = node_handle_.subscribe<sensor_msgs::JointState>(arm_left_state_topic_, 0, &CobInterface::armLeftStateCallback, this);
 
 		node_handle_.param<std::string>("arm_right_command", arm_right_command_, "");
@@ -71,6 +83,10 @@ CobInterface::CobInterface(ros::NodeHandle nh, bool bArmCalibration) :
 
 		node_handle_.param<std::string>("arm_right_state_topic", arm_right_state_topic_, "");
 		std::cout << "arm_right_state_topic: " << arm_right_state_topic_ << std::endl;
+		std::vector<std::string> arm_right_joint_names;
+		node_handle_.getParam("arm_right_joint_names", arm_right_joint_names);
+		arm_right_state_demux_.setJointNames(arm_right_joint_names);
+		arm_right_state_current_.reserve(arm_right_joint_names.size());
 		arm_right_state_ = node_handle_.subscribe<sensor_msgs::JointState>(arm_right_state_topic_, 0, &CobInterface::armRightStateCallback, this);
 	}
 	else
@@ -99,17 +115,17 @@ void CobInterface::getParameterNames(std::vector<std::string>& parameter_names)
 // Callbacks
 void CobInterface::cameraStateCallback(const sensor_msgs::JointState::ConstPtr& msg)
 {
-
+	camera_state_current_.write(msg->position, msg->header.stamp);
 }
 
 void CobInterface::armLeftStateCallback(const sensor_msgs::JointState::ConstPtr& msg)
 {
-
+	arm_left_state_demux_.update(*msg, arm_left_state_current_);
 }
 
 void CobInterface::armRightStateCallback(const sensor_msgs::JointState::ConstPtr& msg)
 {
-
+	arm_right_state_demux_.update(*msg, arm_right_state_current_);
 }
 // End callbacks
 
@@ -123,9 +139,9 @@ void CobInterface::assignNewCameraAngles(std_msgs::Float64MultiArray newAngles)
 
 }
 
-std::vector<double>* CobInterface::getCurrentCameraState()
+JointStateSnapshot CobInterface::getCurrentCameraState()
 {
-	return 0;
+	return camera_state_current_.read();
 }
 
 void CobInterface::assignNewArmJoints(std_msgs::Float64MultiArray newJointConfig)
@@ -133,9 +149,11 @@ void CobInterface::assignNewArmJoints(std_msgs::Float64MultiArray newJointConfig
 
 }
 
-std::vector<double>* CobInterface::getCurrentArmState()
+JointStateSnapshot CobInterface::getCurrentArmState()
 {
-	return 0;
+	if (arm_to_calibrate_.compare("right") == 0)
+		return arm_right_state_current_.read();
+	return arm_left_state_current_.read();
 }
 
 
@@ -0,0 +1,128 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#include <robotino_calibration/joint_state_buffer.h>
+
+
+JointStateBuffer::JointStateBuffer(const size_t capacity, const size_t initial_size) :
+		positions_(new boost::atomic<double>[capacity]), capacity_(capacity), size_(std::min(initial_size, capacity)), stamp_nsec_(0), sequence_(0)
+{
+	for (size_t i=0; i<capacity_; ++i)
+		positions_[i].store(0., boost::memory_order_relaxed);
+}
+
+JointStateBuffer::~JointStateBuffer()
+{
+}
+
+void JointStateBuffer::reserve(const size_t capacity)
+{
+	if (capacity <= capacity_)
+		return;
+
+	boost::scoped_array< boost::atomic<double> > positions(new boost::atomic<double>[capacity]);
+	for (size_t i=0; i<capacity; ++i)
+		positions[i].store(i<capacity_ ? positions_[i].load(boost::memory_order_relaxed) : 0., boost::memory_order_relaxed);
+	positions_.swap(positions);
+	capacity_ = capacity;
+}
+
+void JointStateBuffer::write(const std::vector<double>& positions, const ros::Time& stamp)
+{
+	if (positions.size() > capacity_)
+		ROS_WARN_ONCE("JointStateBuffer::write: joint state with %lu positions exceeds the buffer capacity of %lu, the remaining positions are dropped.",
+				(unsigned long)positions.size(), (unsigned long)capacity_);
+	const size_t size = std::min(positions.size(), capacity_);
+
+	// mark write in progress
+	const unsigned int sequence = sequence_.load(boost::memory_order_relaxed);
+	sequence_.store(sequence+1, boost::memory_order_relaxed);
+	boost::atomic_thread_fence(boost::memory_order_release);
+
+	for (size_t i=0; i<size; ++i)
+		positions_[i].store(positions[i], boost::memory_order_relaxed);
+	size_.store(size, boost::memory_order_relaxed);
+	stamp_nsec_.store(stamp.toNSec(), boost::memory_order_relaxed);
+
+	// publish
+	sequence_.store(sequence+2, boost::memory_order_release);
+}
+
+JointStateSnapshot JointStateBuffer::read() const
+{
+	JointStateSnapshot snapshot;
+	snapshot.positions_.reserve(capacity_);
+
+	while (true)
+	{
+		const unsigned int sequence_before = sequence_.load(boost::memory_order_acquire);
+		if ((sequence_before & 1) == 0)
+		{
+			const size_t size = size_.load(boost::memory_order_relaxed);
+			snapshot.positions_.resize(size);
+			for (size_t i=0; i<size; ++i)
+				snapshot.positions_[i] = positions_[i].load(boost::memory_order_relaxed);
+			const uint64_t stamp_nsec = stamp_nsec_.load(boost::memory_order_relaxed);
+
+			boost::atomic_thread_fence(boost::memory_order_acquire);
+			if (sequence_.load(boost::memory_order_relaxed) == sequence_before)	// no write in between -> copy is consistent
+			{
+				snapshot.stamp_.fromNSec(stamp_nsec);
+				return snapshot;
+			}
+		}
+	}
+}
+
+size_t JointStateBuffer::capacity() const
+{
+	return capacity_;
+}
@@ -0,0 +1,165 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#include <robotino_calibration/joint_state_demultiplexer.h>
+
+
+const size_t JointStateDemultiplexer::NOT_CONTAINED = (size_t)-1;
+const size_t JointStateDemultiplexer::MAX_CACHED_LAYOUTS = 8;
+
+JointStateDemultiplexer::JointStateDemultiplexer(const std::vector<std::string>& joint_names)
+{
+	setJointNames(joint_names);
+}
+
+JointStateDemultiplexer::~JointStateDemultiplexer()
+{
+}
+
+void JointStateDemultiplexer::setJointNames(const std::vector<std::string>& joint_names)
+{
+	joint_names_ = joint_names;
+	index_tables_.clear();
+	index_tables_.reserve(MAX_CACHED_LAYOUTS);
+	positions_.assign(joint_names_.size(), 0.);
+}
+
+const std::vector<std::string>& JointStateDemultiplexer::getJointNames() const
+{
+	return joint_names_;
+}
+
+bool JointStateDemultiplexer::update(const sensor_msgs::JointState& msg, JointStateBuffer& buffer)
+{
+	// no joint names configured -> forward the whole message
+	if (joint_names_.empty())
+	{
+		buffer.write(msg.position, msg.header.stamp);
+		return true;
+	}
+
+	const IndexTable* table = findIndexTable(msg);
+	if (table == 0)
+		table = &resolveIndexTable(msg);
+	if (table->contained_joints_ == 0)
+		return false;	// e.g. a message of another publisher on a merged topic, its cached table rejects it cheaply next time
+
+	for (size_t j=0; j<table->indices_.size(); ++j)
+		if (table->indices_[j] != NOT_CONTAINED)
+			positions_[j] = msg.position[table->indices_[j]];
+	buffer.write(positions_, msg.header.stamp);
+
+	return true;
+}
+
+const JointStateDemultiplexer::IndexTable* JointStateDemultiplexer::findIndexTable(const sensor_msgs::JointState& msg) const
+{
+	for (size_t t=0; t<index_tables_.size(); ++t)
+		if (isIndexTableValid(index_tables_[t], msg))
+			return &index_tables_[t];
+	return 0;
+}
+
+bool JointStateDemultiplexer::isIndexTableValid(const IndexTable& table, const sensor_msgs::JointState& msg) const
+{
+	if (table.name_count_ != msg.name.size() || (!msg.name.empty() && msg.name[0].compare(table.first_name_) != 0))
+		return false;
+
+	if (table.contained_joints_ == 0)
+		return table.names_ == msg.name;
+
+	for (size_t j=0; j<table.indices_.size(); ++j)
+	{
+		const size_t index = table.indices_[j];
+		if (index != NOT_CONTAINED && (index >= msg.position.size() || msg.name[index].compare(joint_names_[j]) != 0))
+			return false;
+	}
+
+	return true;
+}
+
+const JointStateDemultiplexer::IndexTable& JointStateDemultiplexer::resolveIndexTable(const sensor_msgs::JointState& msg)
+{
+	IndexTable table;
+	table.name_count_ = msg.name.size();
+	table.first_name_ = (msg.name.empty() ? std::string() : msg.name[0]);
+	table.indices_.assign(joint_names_.size(), NOT_CONTAINED);
+	table.contained_joints_ = 0;
+	for (size_t j=0; j<joint_names_.size(); ++j)
+	{
+		for (size_t i=0; i<msg.name.size() && i<msg.position.size(); ++i)
+		{
+			if (msg.name[i].compare(joint_names_[j]) == 0)
+			{
+				table.indices_[j] = i;
+				++table.contained_joints_;
+				break;
+			}
+		}
+	}
+
+	if (table.contained_joints_ == 0)
+		table.names_ = msg.name;
+
+	// replace the outdated table of this layout, otherwise add a new one
+	for (size_t t=0; t<index_tables_.size(); ++t)
+	{
+		if (index_tables_[t].name_count_ == table.name_count_ && index_tables_[t].first_name_.compare(table.first_name_) == 0)
+		{
+			index_tables_[t] = table;
+			return index_tables_[t];
+		}
+	}
+	if (index_tables_.size() >= MAX_CACHED_LAYOUTS)
+		index_tables_.erase(index_tables_.begin());
+	index_tables_.push_back(table);
+	return index_tables_.back();
+}
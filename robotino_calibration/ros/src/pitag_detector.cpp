@@ -0,0 +1,260 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/pitag_detector.h>
+#include <robotino_calibration/calibration_utilities.h>
+
+#include <tf/transform_datatypes.h>
+#include <boost/bind.hpp>
+#include <map>
+#include <sstream>
+
+
+// number of processed images that are kept for detect()
+#define PiTagResultHistorySize 10
+
+
+PiTagDetector::PiTagDetector(ros::NodeHandle nh, const std::string& camera_image_topic, const std::string& camera_info_topic, const std::string& model_file) :
+		model_file_(model_file), spinner_(0), pending_passes_(0), initialization_failed_(false), shutdown_(false)
+{
+	pi_tag_ = boost::shared_ptr<ipa_Fiducials::FiducialModelPi>(new ipa_Fiducials::FiducialModelPi());
+
+	ros::NodeHandle detector_nh(nh);
+	detector_nh.setCallbackQueue(&callback_queue_);
+	image_sub_ = detector_nh.subscribe<sensor_msgs::Image>(camera_image_topic, 1, &PiTagDetector::imageCallback, this);
+	camera_info_sub_ = detector_nh.subscribe<sensor_msgs::CameraInfo>(camera_info_topic, 1, &PiTagDetector::cameraInfoCallback, this);
+
+	detection_thread_ = boost::thread(boost::bind(&PiTagDetector::detectionThread, this));
+	spinner_ = new ros::AsyncSpinner(1, &callback_queue_);
+	spinner_->start();
+}
+
+PiTagDetector::~PiTagDetector()
+{
+	if (spinner_ != 0)
+	{
+		spinner_->stop();
+		delete spinner_;
+	}
+
+	{
+		boost::mutex::scoped_lock lock(mutex_);
+		shutdown_ = true;
+	}
+	image_available_.notify_all();
+	detection_thread_.join();
+}
+
+void PiTagDetector::imageCallback(const sensor_msgs::ImageConstPtr& image_msg)
+{
+	{
+		boost::mutex::scoped_lock lock(mutex_);
+		// the detector only runs while detect() waits for images taken after its request
+		if (pending_passes_ == 0 || image_msg->header.stamp < pending_request_time_)
+			return;
+		pending_image_ = image_msg;		// an image that was not processed yet is dropped in favor of the newer one
+	}
+	image_available_.notify_one();
+}
+
+void PiTagDetector::cameraInfoCallback(const sensor_msgs::CameraInfoConstPtr& camera_info_msg)
+{
+	boost::mutex::scoped_lock lock(mutex_);
+	if (camera_matrix_.empty() == false)
+		return;
+
+	camera_matrix_ = cv::Mat::zeros(3, 4, CV_64FC1);
+	for (int v=0; v<3; ++v)
+		for (int u=0; u<4; ++u)
+			camera_matrix_.at<double>(v,u) = camera_info_msg->P[4*v+u];
+	image_available_.notify_one();
+}
+
+void PiTagDetector::detectionThread()
+{
+	bool initialized = false;
+	while (true)
+	{
+		sensor_msgs::ImageConstPtr image_msg;
+		cv::Mat camera_matrix;
+		{
+			boost::mutex::scoped_lock lock(mutex_);
+			while (shutdown_ == false && (!pending_image_ || camera_matrix_.empty() == true))
+				image_available_.wait(lock);
+			if (shutdown_ == true)
+				return;
+			image_msg = pending_image_;
+			pending_image_.reset();
+			camera_matrix = camera_matrix_;
+		}
+
+		// the detector needs the camera intrinsics, so it is initialized with the first camera info
+		if (initialized == false)
+		{
+			if (pi_tag_->Init(camera_matrix, model_file_, false) & ipa_Utils::RET_FAILED)
+			{
+				ROS_ERROR("PiTagDetector: Could not initialize the Pi tag detector with model file %s.", model_file_.c_str());
+				{
+					boost::mutex::scoped_lock lock(mutex_);
+					initialization_failed_ = true;
+					pending_passes_ = 0;
+				}
+				detections_available_.notify_all();
+				return;
+			}
+			initialized = true;
+		}
+
+		cv_bridge::CvImageConstPtr image_ptr;
+		cv::Mat image;
+		if (calibration_utilities::convertImageMessageToMat(image_msg, image_ptr, image) == false)
+			continue;
+
+		cob_object_detection_msgs::DetectionArray detections;
+		detections.header = image_msg->header;
+		std::vector<ipa_Fiducials::t_pose> tags;
+		if (pi_tag_->GetPose(image, tags) & ipa_Utils::RET_OK)
+			convertDetections(tags, image_msg->header, detections);
+
+		{
+			boost::mutex::scoped_lock lock(mutex_);
+			results_.push_back(detections);
+			if (results_.size() > PiTagResultHistorySize)
+				results_.pop_front();
+			if (pending_passes_ > 0 && image_msg->header.stamp >= pending_request_time_)
+				--pending_passes_;
+		}
+		detections_available_.notify_all();
+	}
+}
+
+void PiTagDetector::convertDetections(const std::vector<ipa_Fiducials::t_pose>& tags, const std_msgs::Header& header, cob_object_detection_msgs::DetectionArray& detections) const
+{
+	for (size_t i=0; i<tags.size(); ++i)
+	{
+		cob_object_detection_msgs::Detection detection;
+		std::stringstream ss;
+		ss << "tag_" << tags[i].id;
+		detection.label = ss.str();
+		detection.detector = "Fiducial_PI";
+		detection.score = 0;
+		detection.header = header;
+
+		// the detector returns the tag orientation as rotation vector and its position in camera_optical_frame coordinates
+		cv::Mat rot_3x3;
+		cv::Rodrigues(tags[i].rot, rot_3x3);
+		tf::Matrix3x3 rotation(rot_3x3.at<double>(0,0), rot_3x3.at<double>(0,1), rot_3x3.at<double>(0,2),
+				rot_3x3.at<double>(1,0), rot_3x3.at<double>(1,1), rot_3x3.at<double>(1,2),
+				rot_3x3.at<double>(2,0), rot_3x3.at<double>(2,1), rot_3x3.at<double>(2,2));
+		tf::Quaternion quaternion;
+		rotation.getRotation(quaternion);
+		detection.pose.header = header;
+		detection.pose.pose.position.x = tags[i].trans.at<double>(0);
+		detection.pose.pose.position.y = tags[i].trans.at<double>(1);
+		detection.pose.pose.position.z = tags[i].trans.at<double>(2);
+		tf::quaternionTFToMsg(quaternion, detection.pose.pose.orientation);
+
+		detections.detections.push_back(detection);
+	}
+}
+
+bool PiTagDetector::detect(const ros::Time& request_time, const int number_passes, const ros::Duration& timeout, cob_object_detection_msgs::DetectionArray& detections)
+{
+	const boost::system_time deadline = boost::get_system_time() + boost::posix_time::milliseconds((long)(timeout.toSec()*1000.));
+	const size_t passes = (number_passes > 0 ? number_passes : 1);
+
+	boost::mutex::scoped_lock lock(mutex_);
+	if (initialization_failed_ == true)
+	{
+		ROS_ERROR("PiTagDetector: The Pi tag detector could not be initialized with model file %s.", model_file_.c_str());
+		return false;
+	}
+	pending_request_time_ = request_time;
+	while (true)
+	{
+		// gather the results of images taken after the request
+		std::vector<const cob_object_detection_msgs::DetectionArray*> fresh_results;
+		for (size_t i=0; i<results_.size(); ++i)
+			if (results_[i].header.stamp >= request_time)
+				fresh_results.push_back(&results_[i]);
+
+		// the detection thread is idle as soon as no more passes are needed
+		pending_passes_ = (fresh_results.size() < passes ? passes-fresh_results.size() : 0);
+		if (fresh_results.size() >= passes)
+		{
+			// merge the passes, the latest detection of every tag wins
+			std::map<std::string, cob_object_detection_msgs::Detection> merged;
+			for (size_t i=0; i<passes; ++i)
+				for (size_t j=0; j<fresh_results[i]->detections.size(); ++j)
+					merged[fresh_results[i]->detections[j].label] = fresh_results[i]->detections[j];
+
+			detections.header = fresh_results[passes-1]->header;
+			detections.detections.clear();
+			for (std::map<std::string, cob_object_detection_msgs::Detection>::iterator it=merged.begin(); it!=merged.end(); ++it)
+				detections.detections.push_back(it->second);
+			return true;
+		}
+
+		if (detections_available_.timed_wait(lock, deadline) == false)
+		{
+			pending_passes_ = 0;
+			ROS_WARN("PiTagDetector: Did not receive %d processed camera images within %f s.", (int)passes, timeout.toSec());
+			return false;
+		}
+		if (initialization_failed_ == true)
+		{
+			ROS_ERROR("PiTagDetector: The Pi tag detector could not be initialized with model file %s.", model_file_.c_str());
+			return false;
+		}
+	}
+}
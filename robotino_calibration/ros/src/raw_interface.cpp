@@ -59,7 +59,8 @@
 
 
 RAWInterface::RAWInterface(ros::NodeHandle nh, bool do_arm_calibration) :
-				CalibrationInterface(nh), arm_state_current_(0)
+				CalibrationInterface(nh), camera_state_current_(32, 2),
+				camera_state_demux_(std::vector<std::string>()), arm_state_demux_(std::vector<std::string>())
 {
 	std::cout << "\n========== RAWInterface Parameters ==========\n";
 
@@ -70,10 +71,18 @@ RAWInterface::RAWInterface(ros::NodeHandle nh, bool do_arm_calibration) :
 
 	node_handle_.param<std::string>("camera_joint_state_topic", camera_joint_state_topic_, "/torso/joint_states");
 	std::cout << "camera_joint_state_topic: " << camera_joint_state_topic_ << std::endl;
+	std::vector<std::string> camera_joint_names;
+	camera_joint_names.push_back("torso_bottom_joint");
+	camera_joint_names.push_back("torso_side_joint");
+	node_handle_.getParam("camera_joint_names", camera_joint_names);
+	std::cout << "camera_joint_names:";
+	for (size_t i=0; i<camera_joint_names.size(); ++i)
+		std::cout << " " << camera_joint_names[i];
+	std::cout << std::endl;
+	camera_state_demux_.setJointNames(camera_joint_names);
+	camera_state_current_.reserve(camera_joint_names.size());
 	camera_state_ = node_handle_.subscribe<sensor_msgs::JointState>(camera_joint_state_topic_, 0, &RAWInterface::cameraStateCallback, this);
 
-	camera_state_current_.resize(2);
-
 	if (do_arm_calibration)
 	{
 		node_handle_.param<std::string>("arm_joint_controller_command", arm_joint_controller_command_, "/arm/joint_trajectory_controller/command");
@@ -82,6 +91,20 @@ RAWInterface::RAWInterface(ros::NodeHandle nh, bool do_arm_calibration) :
 
 		node_handle_.param<std::string>("arm_state_topic", arm_state_topic_, "/arm/joint_states");
 		std::cout << "arm_state_topic: " << arm_state_topic_ << std::endl;
+		std::vector<std::string> arm_joint_names;
+		arm_joint_names.push_back("arm_shoulder_pan_joint");
+		arm_joint_names.push_back("arm_shoulder_lift_joint");
+		arm_joint_names.push_back("arm_elbow_joint");
+		arm_joint_names.push_back("arm_wrist_1_joint");
+		arm_joint_names.push_back("arm_wrist_2_joint");
+		arm_joint_names.push_back("arm_wrist_3_joint");
+		node_handle_.getParam("arm_joint_names", arm_joint_names);
+		std::cout << "arm_joint_names:";
+		for (size_t i=0; i<arm_joint_names.size(); ++i)
+			std::cout << " " << arm_joint_names[i];
+		std::cout << std::endl;
+		arm_state_demux_.setJointNames(arm_joint_names);
+		arm_state_current_.reserve(arm_joint_names.size());
 		arm_state_ = node_handle_.subscribe<sensor_msgs::JointState>(arm_state_topic_, 0, &RAWInterface::armStateCallback, this);
 	}
 	else
@@ -112,16 +135,12 @@ void RAWInterface::getParameterNames(std::vector<std::string>& parameter_names)
 //Callbacks - User defined
 void RAWInterface::cameraStateCallback(const sensor_msgs::JointState::ConstPtr& msg)
 {
-	boost::mutex::scoped_lock lock(pan_tilt_joint_state_data_mutex_);
-	camera_state_current_[0] = msg->position[0];
-	camera_state_current_[1] = msg->position[1];
+	camera_state_demux_.update(*msg, camera_state_current_);
 }
 
 void RAWInterface::armStateCallback(const sensor_msgs::JointState::ConstPtr& msg)
 {
-	boost::mutex::scoped_lock lock(arm_state_data_mutex_);
-	arm_state_current_ = new sensor_msgs::JointState;
-	*arm_state_current_ = *msg;
+	arm_state_demux_.update(*msg, arm_state_current_);
 }
 // End Callbacks
 
@@ -141,11 +160,11 @@ void RAWInterface::assignNewCameraAngles(std_msgs::Float64MultiArray new_angles)
 	control_msgs::FollowJointTrajectoryGoal camGoal;
 
 	ac.waitForServer();
-	jointTraj.joint_names = {"torso_bottom_joint", "torso_side_joint"};
+	jointTraj.joint_names = camera_state_demux_.getJointNames();
 	jointTrajPoint.positions.insert(jointTrajPoint.positions.end(), new_angles.data.begin(), new_angles.data.end());
 	jointTrajPoint.time_from_start = ros::Duration(2);
-	jointTrajPoint.velocities = {0,0}; //Initialize velocities to zero, does not work with empty list
-	jointTrajPoint.accelerations = {0,0};
+	jointTrajPoint.velocities.assign(jointTraj.joint_names.size(), 0.); //Initialize velocities to zero, does not work with empty list
+	jointTrajPoint.accelerations.assign(jointTraj.joint_names.size(), 0.);
 	jointTraj.points.push_back(jointTrajPoint);
 	jointTraj.header.stamp = ros::Time::now();
 
@@ -154,9 +173,9 @@ void RAWInterface::assignNewCameraAngles(std_msgs::Float64MultiArray new_angles)
 	//camera_joint_controller_.publish(new_angles/*jointTraj*/);
 }
 
-std::vector<double>* RAWInterface::getCurrentCameraState()
+JointStateSnapshot RAWInterface::getCurrentCameraState()
 {
-	return &camera_state_current_;
+	return camera_state_current_.read();
 }
 // END CALIBRATION INTERFACE
 
@@ -170,16 +189,16 @@ void RAWInterface::assignNewArmJoints(std_msgs::Float64MultiArray new_joint_conf
 	actionlib::SimpleActionClient<control_msgs::FollowJointTrajectoryAction> ac("/arm/joint_trajectory_controller/follow_joint_trajectory", true);
 	control_msgs::FollowJointTrajectoryGoal armGoal;
 	ac.waitForServer();
-	jointTraj.joint_names = {"arm_shoulder_pan_joint", "arm_shoulder_lift_joint", "arm_elbow_joint", "arm_wrist_1_joint", "arm_wrist_2_joint", "arm_wrist_3_joint"};
-			//{"arm_elbow_joint", "arm_shoulder_lift_joint", "arm_shoulder_pan_joint", "arm_wrist_1_joint", "arm_wrist_2_joint", "arm_wrist_3_joint"};
+	jointTraj.joint_names = arm_state_demux_.getJointNames();
 	jointTrajPoint.positions.insert(jointTrajPoint.positions.end(), new_joint_config.data.begin(), new_joint_config.data.end());
 	jointTrajPoint.time_from_start = ros::Duration(2);
-	currentPoint.positions.insert(currentPoint.positions.end(), arm_state_current_->position.begin(), arm_state_current_->position.end());
-	currentPoint.velocities = {0,0,0,0,0,0};
-	currentPoint.accelerations = {0,0,0,0,0,0};
+	const JointStateSnapshot arm_state = arm_state_current_.read();
+	currentPoint.positions.insert(currentPoint.positions.end(), arm_state.positions_.begin(), arm_state.positions_.end());
+	currentPoint.velocities.assign(jointTraj.joint_names.size(), 0.);
+	currentPoint.accelerations.assign(jointTraj.joint_names.size(), 0.);
 	jointTraj.points.push_back(currentPoint);
-	jointTrajPoint.velocities = {0,0,0,0,0,0};
-	jointTrajPoint.accelerations = {0,0,0,0,0,0};
+	jointTrajPoint.velocities.assign(jointTraj.joint_names.size(), 0.);
+	jointTrajPoint.accelerations.assign(jointTraj.joint_names.size(), 0.);
 	jointTraj.points.push_back(jointTrajPoint);
 	jointTraj.header.stamp = ros::Time::now();
 	armGoal.trajectory = jointTraj;
@@ -190,10 +209,9 @@ void RAWInterface::assignNewArmJoints(std_msgs::Float64MultiArray new_joint_conf
 	//arm_joint_controller_.publish(jointTraj); // RAW3-1
 }
 
-std::vector<double>* RAWInterface::getCurrentArmState()
+JointStateSnapshot RAWInterface::getCurrentArmState()
 {
-	boost::mutex::scoped_lock lock(arm_state_data_mutex_);
-	return &arm_state_current_->position;
+	return arm_state_current_.read();
 }
 // END
 
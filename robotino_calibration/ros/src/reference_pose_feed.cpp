@@ -0,0 +1,161 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/reference_pose_feed.h>
+#include <robotino_calibration/transformation_utilities.h>
+
+#include <boost/bind.hpp>
+
+
+ReferencePoseFeed::ReferencePoseFeed(const tf::TransformListener& transform_listener, const std::string& target_frame, const std::string& source_frame,
+		const double update_rate, const ros::Duration& max_age) :
+		transform_listener_(transform_listener), target_frame_(target_frame), source_frame_(source_frame), update_rate_(update_rate),
+		max_age_(max_age), running_(false)
+{
+	if (update_rate_ <= 0.)
+		update_rate_ = 50.;
+}
+
+ReferencePoseFeed::~ReferencePoseFeed()
+{
+	stop();
+}
+
+void ReferencePoseFeed::setStaleCallback(const boost::function<void ()>& stale_callback)
+{
+	stale_callback_ = stale_callback;
+}
+
+void ReferencePoseFeed::start()
+{
+	if (running_.exchange(true) == true)
+		return;
+	feed_thread_ = boost::thread(boost::bind(&ReferencePoseFeed::feedThread, this));
+}
+
+void ReferencePoseFeed::stop()
+{
+	running_.store(false);
+	if (feed_thread_.joinable())
+		feed_thread_.join();
+}
+
+bool ReferencePoseFeed::getLatestPose(cv::Mat& T, ros::Duration& age) const
+{
+	StampedPose pose;
+	if (pose_buffer_.read(pose) == false)
+		return false;
+
+	T = cv::Mat(4, 4, CV_64FC1);
+	for (int i=0; i<16; ++i)
+		T.at<double>(i/4, i%4) = pose.T_[i];
+	age = ros::Time::now() - pose.stamp_;
+	return true;
+}
+
+bool ReferencePoseFeed::isFresh() const
+{
+	StampedPose pose;
+	return (pose_buffer_.read(pose) == true && ros::Time::now() - pose.stamp_ <= max_age_);
+}
+
+const ros::Duration& ReferencePoseFeed::getMaxAge() const
+{
+	return max_age_;
+}
+
+void ReferencePoseFeed::feedThread()
+{
+	const boost::posix_time::microseconds period((long)(1e6/update_rate_));
+	ros::Time last_stamp;
+	bool stale = false;
+	StampedPose pose;
+
+	while (running_.load() == true && ros::ok())
+	{
+		// only take what is already in the TF buffer, the control loop must not wait for late data
+		if (transform_listener_.canTransform(target_frame_, source_frame_, ros::Time(0)) == true)
+		{
+			try
+			{
+				tf::StampedTransform Ts;
+				transform_listener_.lookupTransform(target_frame_, source_frame_, ros::Time(0), Ts);
+				if (Ts.stamp_ != last_stamp)
+				{
+					const cv::Mat T = transform_utilities::transformToMat(Ts);
+					for (int i=0; i<16; ++i)
+						pose.T_[i] = T.at<double>(i/4, i%4);
+					pose.stamp_ = Ts.stamp_;
+					pose_buffer_.write(pose);
+					last_stamp = Ts.stamp_;
+				}
+			}
+			catch (tf::TransformException& ex)
+			{
+				ROS_WARN_THROTTLE(1.0, "%s", ex.what());
+			}
+		}
+
+		// watchdog
+		const bool fresh = isFresh();
+		if (fresh == false && stale == false)
+		{
+			ROS_WARN("ReferencePoseFeed: No update of the transform from %s to %s for more than %f s.", target_frame_.c_str(), source_frame_.c_str(), max_age_.toSec());
+			if (stale_callback_)
+				stale_callback_();
+		}
+		stale = !fresh;
+
+		boost::this_thread::sleep(period);
+	}
+}
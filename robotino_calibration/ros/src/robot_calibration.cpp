@@ -61,7 +61,7 @@
 
 
 RobotCalibration::RobotCalibration(ros::NodeHandle nh, bool do_arm_calibration) :
-		node_handle_(nh), transform_listener_(nh), calibrated_(false)
+		node_handle_(nh), transform_listener_(nh), static_transform_cache_(nh, transform_listener_), calibrated_(false)
 {
 	// load parameters
 	std::cout << "\n========== Calibration Parameters ==========\n";
@@ -71,6 +71,31 @@ RobotCalibration::RobotCalibration(ros::NodeHandle nh, bool do_arm_calibration)
 	std::cout << "calibration_storage_path: " << calibration_storage_path_ << std::endl;
 	node_handle_.param("calibration_ID", calibration_ID_, 0);
 	std::cout << "calibration_ID: " << calibration_ID_ << std::endl;
+	node_handle_.param("resume_acquisition", resume_acquisition_, false);
+	std::cout << "resume_acquisition: " << resume_acquisition_ << std::endl;
+	node_handle_.param("acquisition_worker_threads", acquisition_worker_threads_, 1);
+	std::cout << "acquisition_worker_threads: " << acquisition_worker_threads_ << std::endl;
+	node_handle_.param("acquisition_queue_size", acquisition_queue_size_, 2);
+	std::cout << "acquisition_queue_size: " << acquisition_queue_size_ << std::endl;
+	node_handle_.param<std::string>("image_storage_mode", image_storage_mode_, "full");
+	std::cout << "image_storage_mode: " << image_storage_mode_ << std::endl;
+	if (image_storage_mode_ != "full" && image_storage_mode_ != "corners")
+	{
+		ROS_WARN("Unknown image_storage_mode '%s', storing full images.", image_storage_mode_.c_str());
+		image_storage_mode_ = "full";
+	}
+	node_handle_.param("thumbnail_scale", thumbnail_scale_, 0.25);
+	std::cout << "thumbnail_scale: " << thumbnail_scale_ << std::endl;
+	node_handle_.param("thumbnail_jpeg_quality", thumbnail_jpeg_quality_, 80);
+	std::cout << "thumbnail_jpeg_quality: " << thumbnail_jpeg_quality_ << std::endl;
+	double transform_lookup_timeout = 0.2;
+	node_handle_.param("transform_lookup_timeout", transform_lookup_timeout, 0.2);
+	std::cout << "transform_lookup_timeout: " << transform_lookup_timeout << std::endl;
+	transform_lookup_timeout_ = ros::Duration(transform_lookup_timeout);
+	int static_transform_stability_count = 3;
+	node_handle_.param("static_transform_stability_count", static_transform_stability_count, 3);
+	std::cout << "static_transform_stability_count: " << static_transform_stability_count << std::endl;
+	static_transform_cache_.setStabilityCount(static_transform_stability_count);
 
 /*
 	// load gaps including its initial values
@@ -184,6 +209,28 @@ void RobotCalibration::createStorageFolder()
 	}
 }
 
+void RobotCalibration::startAcquisitionSession(AcquisitionCheckpoint& checkpoint)
+{
+	if (resume_acquisition_ && checkpoint.load())
+	{
+		std::cout << "Resuming acquisition, " << checkpoint.getCapturedCount() << " configurations have already been captured." << std::endl;
+		return;
+	}
+
+	if (resume_acquisition_)
+		ROS_WARN("No matching checkpoint found, starting a new acquisition session.");
+	checkpoint.clear();
+}
+
+bool RobotCalibration::storeViewImage(const cv::Mat& image, const bool pattern_found, SessionArchiveRecord& record) const
+{
+	// full images of failed detections are kept for debugging
+	if (image_storage_mode_ == "full" || pattern_found == false)
+		return record.encodeImage(image);
+
+	return record.encodeThumbnail(image, thumbnail_scale_, thumbnail_jpeg_quality_);
+}
+
 void RobotCalibration::setCalibrationStatus(bool calibrated)
 {
 		calibrated_ = calibrated;
@@ -53,7 +53,8 @@
 // ToDo: Adjust interface to new topics
 
 RobotinoInterface::RobotinoInterface(ros::NodeHandle nh, bool do_arm_calibration) :
-				CalibrationInterface(nh), camera_state_current_(2, 0.), arm_state_current_(0)
+				CalibrationInterface(nh), camera_state_current_(32, 2),
+				camera_state_demux_(std::vector<std::string>()), arm_state_demux_(std::vector<std::string>())
 {
 	std::cout << "\n========== RobotinoInterface Parameters ==========\n";
 
@@ -71,6 +72,11 @@ RobotinoInterface::RobotinoInterface(ros::NodeHandle nh, bool do_arm_calibration
 	std::cout << "pan_joint_name: " << pan_joint_name_ << std::endl;
 	node_handle_.param<std::string>("tilt_joint_name", tilt_joint_name_, "neck_tilt_joint");
 	std::cout << "tilt_joint_name: " << tilt_joint_name_ << std::endl;
+	std::vector<std::string> camera_joint_names;
+	camera_joint_names.push_back(pan_joint_name_);
+	camera_joint_names.push_back(tilt_joint_name_);
+	camera_state_demux_.setJointNames(camera_joint_names);
+	camera_state_current_.reserve(camera_joint_names.size());
 
 	camera_joint_state_sub_ = node_handle_.subscribe<sensor_msgs::JointState>(camera_joint_state_topic_, 0, &RobotinoInterface::cameraJointStateCallback, this);
 
@@ -82,6 +88,14 @@ RobotinoInterface::RobotinoInterface(ros::NodeHandle nh, bool do_arm_calibration
 
 		node_handle_.param<std::string>("arm_state_topic", arm_state_topic_, "/arm_controller/joint_states");
 		std::cout << "arm_state_topic: " << arm_state_topic_ << std::endl;
+		std::vector<std::string> arm_joint_names;
+		node_handle_.getParam("arm_joint_names", arm_joint_names);
+		std::cout << "arm_joint_names:";
+		for (size_t i=0; i<arm_joint_names.size(); ++i)
+			std::cout << " " << arm_joint_names[i];
+		std::cout << std::endl;
+		arm_state_demux_.setJointNames(arm_joint_names);
+		arm_state_current_.reserve(arm_joint_names.size());
 		arm_state_ = node_handle_.subscribe<sensor_msgs::JointState>(arm_state_topic_, 0, &RobotinoInterface::armStateCallback, this);
 	}
 	else
@@ -109,25 +123,12 @@ void RobotinoInterface::getParameterNames(std::vector<std::string>& parameter_na
 //Callbacks - User defined
 void RobotinoInterface::cameraJointStateCallback(const sensor_msgs::JointState::ConstPtr& msg)
 {
-	boost::mutex::scoped_lock lock(camera_joint_state_data_mutex_);
-	if (camera_state_current_.size() >= 2)
-	{
-		for (size_t i=0; i<msg->name.size(); ++i)
-		{
-			const std::string& name = msg->name[i];
-			if (name.compare(pan_joint_name_)==0)
-				camera_state_current_[0] = msg->position[i];
-			if (name.compare(tilt_joint_name_)==0)
-				camera_state_current_[1] = msg->position[i];
-		}
-	}
+	camera_state_demux_.update(*msg, camera_state_current_);
 }
 
 void RobotinoInterface::armStateCallback(const sensor_msgs::JointState::ConstPtr& msg)
 {
-	boost::mutex::scoped_lock lock(arm_state_data_mutex_);
-	arm_state_current_ = new sensor_msgs::JointState;
-	*arm_state_current_ = *msg;
+	arm_state_demux_.update(*msg, arm_state_current_);
 }
 // End Callbacks
 
@@ -147,10 +148,9 @@ void RobotinoInterface::assignNewCameraAngles(std_msgs::Float64MultiArray new_an
 	tilt_controller_.publish(angle);
 }
 
-std::vector<double>* RobotinoInterface::getCurrentCameraState()
+JointStateSnapshot RobotinoInterface::getCurrentCameraState()
 {
-	boost::mutex::scoped_lock lock(camera_joint_state_data_mutex_);
-	return &camera_state_current_;
+	return camera_state_current_.read();
 }
 // END CALIBRATION INTERFACE
 
@@ -162,10 +162,9 @@ void RobotinoInterface::assignNewArmJoints(std_msgs::Float64MultiArray new_joint
 	arm_joint_controller_.publish(new_joint_config);
 }
 
-std::vector<double>* RobotinoInterface::getCurrentArmState()
+JointStateSnapshot RobotinoInterface::getCurrentArmState()
 {
-	boost::mutex::scoped_lock lock(arm_state_data_mutex_);
-	return &arm_state_current_->position;
+	return arm_state_current_.read();
 }
 // END
 
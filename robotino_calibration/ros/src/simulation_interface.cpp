@@ -0,0 +1,455 @@
+/****************************************************************
+ *
+ * Copyright (c) 2015
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: squirrel
+ * ROS stack name: squirrel_calibration
+ * ROS package name: robotino_calibration
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Author: Marc Riedlinger, email:marc.riedlinger@ipa.fraunhofer.de
+ *
+ * Date of creation: October 2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+
+
+#include <robotino_calibration/simulation_interface.h>
+#include <robotino_calibration/fixed_rate_loop.h>
+
+#include <cv_bridge/cv_bridge.h>
+#include <boost/bind.hpp>
+#include <cmath>
+
+
+SimulationInterface::SimulationInterface(ros::NodeHandle nh, bool do_arm_calibration) :
+				CalibrationInterface(nh), camera_state_current_(32, 2), arm_state_current_(32, 0), rng_(12345), it_(0), service_spinner_(0), running_(false)
+{
+	std::cout << "\n========== SimulationInterface Parameters ==========\n";
+
+	// frames, identical to the calibration parameters
+	node_handle_.param<std::string>("base_frame", base_frame_, "base_link");
+	node_handle_.param<std::string>("child_frame_name", child_frame_name_, "/landmark_reference_nav");
+	node_handle_.param<std::string>("torso_lower_frame", torso_lower_frame_, "base_pan_link");
+	node_handle_.param<std::string>("torso_upper_frame", torso_upper_frame_, "tilt_link");
+	node_handle_.param<std::string>("camera_frame", camera_frame_, "kinect_link");
+	node_handle_.param<std::string>("camera_optical_frame", camera_optical_frame_, "kinect_rgb_optical_frame");
+	node_handle_.param<std::string>("checkerboard_frame", checkerboard_frame_, "checkerboard_frame");
+	node_handle_.param<std::string>("marker_frame_base_name", marker_frame_base_name_, "tag");
+	std::string pan_joint_name, tilt_joint_name;
+	node_handle_.param<std::string>("pan_joint_name", pan_joint_name, "neck_pan_joint");
+	node_handle_.param<std::string>("tilt_joint_name", tilt_joint_name, "neck_tilt_joint");
+	camera_joint_names_.push_back(pan_joint_name);
+	camera_joint_names_.push_back(tilt_joint_name);
+	node_handle_.getParam("arm_joint_names", arm_joint_names_);
+	arm_state_current_.reserve(arm_joint_names_.size());
+
+	// ground truth
+	T_base_to_torso_lower_description_ = readTransformParameter("simulation_T_base_to_torso_lower", tf::Transform(tf::Quaternion::getIdentity(), tf::Vector3(0.25, 0., 0.5)));
+	T_torso_upper_to_camera_description_ = readTransformParameter("simulation_T_torso_upper_to_camera", tf::Transform(tf::Quaternion::getIdentity(), tf::Vector3(0., 0.065, 0.)));
+	T_base_to_torso_lower_ = T_base_to_torso_lower_description_ * readTransformParameter("simulation_T_base_to_torso_lower_error", tf::Transform::getIdentity());
+	T_torso_upper_to_camera_ = T_torso_upper_to_camera_description_ * readTransformParameter("simulation_T_torso_upper_to_camera_error", tf::Transform::getIdentity());
+	tf::Matrix3x3 optical_rotation;
+	optical_rotation.setEulerYPR(-0.5*CV_PI, 0., -0.5*CV_PI);		// z forward, x right, y down
+	T_camera_to_camera_optical_ = tf::Transform(optical_rotation, tf::Vector3(0., 0., 0.));
+
+	// dynamics
+	node_handle_.param("simulation_rate", simulation_rate_, 100.);
+	std::cout << "simulation_rate: " << simulation_rate_ << std::endl;
+	node_handle_.param("simulation_base_time_constant", base_time_constant_, 0.2);
+	std::cout << "simulation_base_time_constant: " << base_time_constant_ << std::endl;
+	node_handle_.param("simulation_joint_time_constant", joint_time_constant_, 0.3);
+	std::cout << "simulation_joint_time_constant: " << joint_time_constant_ << std::endl;
+	std::vector<double> initial_pose;
+	node_handle_.getParam("simulation_initial_pose", initial_pose);
+	if (initial_pose.size() != 3)
+	{
+		initial_pose.resize(3, 0.);
+		initial_pose[0] = -1.5;
+	}
+	std::cout << "simulation_initial_pose: " << initial_pose[0] << ", " << initial_pose[1] << ", " << initial_pose[2] << std::endl;
+	for (int i=0; i<3; ++i)
+	{
+		base_pose_[i] = initial_pose[i];
+		base_velocity_[i] = 0.;
+	}
+	camera_joints_.resize(camera_joint_names_.size(), 0.);
+	camera_joints_target_ = camera_joints_;
+	arm_joints_.resize(arm_joint_names_.size(), 0.);
+	arm_joints_target_ = arm_joints_;
+
+	// observations
+	std::vector<double> intrinsics;
+	node_handle_.getParam("simulation_camera_intrinsics", intrinsics);
+	if (intrinsics.size() != 4)
+	{
+		intrinsics.clear();
+		intrinsics.push_back(525.); intrinsics.push_back(525.); intrinsics.push_back(319.5); intrinsics.push_back(239.5);
+	}
+	std::cout << "simulation_camera_intrinsics: " << intrinsics[0] << ", " << intrinsics[1] << ", " << intrinsics[2] << ", " << intrinsics[3] << std::endl;
+	camera_matrix_ = (cv::Mat_<double>(3,3) << intrinsics[0], 0., intrinsics[2], 0., intrinsics[1], intrinsics[3], 0., 0., 1.);
+	std::vector<int> image_size;
+	node_handle_.getParam("simulation_image_size", image_size);
+	image_size_ = (image_size.size() == 2 ? cv::Size(image_size[0], image_size[1]) : cv::Size(640, 480));
+	std::cout << "simulation_image_size: " << image_size_ << std::endl;
+	node_handle_.param("simulation_image_rate", image_rate_, 10.);
+	std::cout << "simulation_image_rate: " << image_rate_ << std::endl;
+	node_handle_.param("simulation_detection_noise", detection_noise_, 0.002);
+	std::cout << "simulation_detection_noise: " << detection_noise_ << std::endl;
+	int seed = 12345;
+	node_handle_.param("simulation_seed", seed, 12345);
+	std::cout << "simulation_seed: " << seed << std::endl;
+	rng_ = cv::RNG(seed);
+	node_handle_.param("chessboard_cell_size", chessboard_cell_size_, 0.05);
+	chessboard_pattern_size_ = cv::Size(6,4);
+	std::vector<double> temp;
+	node_handle_.getParam("chessboard_pattern_size", temp);
+	if (temp.size() == 2)
+		chessboard_pattern_size_ = cv::Size(temp[0], temp[1]);
+
+	// publishers and the fiducial service replacing cob_fiducials
+	std::string camera_image_topic, get_fiducials_topic;
+	node_handle_.param<std::string>("camera_image_topic", camera_image_topic, "/kinect/rgb/image_raw");
+	node_handle_.param<std::string>("get_fiducials_topic", get_fiducials_topic, "/fiducials/get_fiducials");
+	joint_state_pub_ = node_handle_.advertise<sensor_msgs::JointState>("/joint_states", 1, false);
+	camera_info_pub_ = node_handle_.advertise<sensor_msgs::CameraInfo>(camera_image_topic.substr(0, camera_image_topic.find_last_of('/')) + "/camera_info", 1, false);
+	it_ = new image_transport::ImageTransport(node_handle_);
+	image_pub_ = it_->advertise(camera_image_topic, 1);
+	ros::NodeHandle service_nh(node_handle_);
+	service_nh.setCallbackQueue(&service_queue_);
+	fiducials_service_ = service_nh.advertiseService(get_fiducials_topic, &SimulationInterface::detectFiducialsCallback, this);
+	service_spinner_ = new ros::AsyncSpinner(1, &service_queue_);
+	service_spinner_->start();
+
+	// the robot has to exist in TF before the calibration starts
+	running_ = true;
+	simulation_thread_ = boost::thread(boost::bind(&SimulationInterface::simulationThread, this));
+	ros::Duration(0.5).sleep();
+
+	if (do_arm_calibration)
+		ROS_WARN("SimulationInterface: the arm is only simulated on joint level, arm calibration observations are not synthesized.");
+
+	ROS_INFO("SimulationInterface initialized.");
+}
+
+SimulationInterface::~SimulationInterface()
+{
+	running_ = false;
+	if (simulation_thread_.joinable())
+		simulation_thread_.join();
+	if (service_spinner_ != 0)
+	{
+		service_spinner_->stop();
+		delete service_spinner_;
+	}
+	if (it_ != 0)
+		delete it_;
+}
+
+tf::Transform SimulationInterface::readTransformParameter(const std::string& name, const tf::Transform& default_transform)
+{
+	std::vector<double> values;
+	node_handle_.getParam(name, values);
+	tf::Transform transform = default_transform;
+	if (values.size() == 6)
+	{
+		tf::Matrix3x3 rotation;
+		rotation.setEulerYPR(values[3], values[4], values[5]);
+		transform = tf::Transform(rotation, tf::Vector3(values[0], values[1], values[2]));
+	}
+	const tf::Vector3& t = transform.getOrigin();
+	double yaw, pitch, roll;
+	transform.getBasis().getEulerYPR(yaw, pitch, roll);
+	std::cout << name << ": " << t.x() << ", " << t.y() << ", " << t.z() << ", " << yaw << ", " << pitch << ", " << roll << std::endl;
+	return transform;
+}
+
+double SimulationInterface::firstOrder(const double value, const double target, const double dt, const double tau)
+{
+	const double alpha = (tau > dt ? dt/tau : 1.);
+	return value + alpha*(target - value);
+}
+
+void SimulationInterface::simulationThread()
+{
+	FixedRateLoop loop(simulation_rate_);
+	const double dt = 1./simulation_rate_;
+	const int steps_per_image = std::max(1, (int)(simulation_rate_/std::max(image_rate_, 1e-3) + 0.5));
+
+	for (int step=0; running_ == true && ros::ok(); ++step)
+	{
+		const ros::Time stamp = ros::Time::now();
+		tf::Transform T_base_to_reference, T_base_to_camera_optical;
+		{
+			boost::mutex::scoped_lock lock(state_mutex_);
+
+			// like real base drivers, stop if the velocity commands cease
+			geometry_msgs::Twist command = commanded_velocity_;
+			if ((stamp - commanded_velocity_time_).toSec() > 0.5)
+				command = geometry_msgs::Twist();
+			base_velocity_[0] = firstOrder(base_velocity_[0], command.linear.x, dt, base_time_constant_);
+			base_velocity_[1] = firstOrder(base_velocity_[1], command.linear.y, dt, base_time_constant_);
+			base_velocity_[2] = firstOrder(base_velocity_[2], command.angular.z, dt, base_time_constant_);
+			const double c = cos(base_pose_[2]), s = sin(base_pose_[2]);
+			base_pose_[0] += (c*base_velocity_[0] - s*base_velocity_[1])*dt;
+			base_pose_[1] += (s*base_velocity_[0] + c*base_velocity_[1])*dt;
+			base_pose_[2] += base_velocity_[2]*dt;
+
+			for (size_t i=0; i<camera_joints_.size(); ++i)
+				camera_joints_[i] = firstOrder(camera_joints_[i], camera_joints_target_[i], dt, joint_time_constant_);
+			for (size_t i=0; i<arm_joints_.size(); ++i)
+				arm_joints_[i] = firstOrder(arm_joints_[i], arm_joints_target_[i], dt, joint_time_constant_);
+
+			publishState(stamp);
+			T_base_to_reference = published_T_base_to_reference_;
+			T_base_to_camera_optical = published_T_base_to_camera_optical_;
+		}
+
+		if (step % steps_per_image == 0)
+			publishImage(stamp, T_base_to_reference, T_base_to_camera_optical);
+
+		loop.sleep();
+	}
+}
+
+void SimulationInterface::publishState(const ros::Time& stamp)
+{
+	// base_frame is the root of the simulated TF tree, the reference frame is attached to it like relative_localization does
+	tf::Quaternion base_rotation;
+	base_rotation.setRPY(0., 0., base_pose_[2]);
+	const tf::Transform T_reference_to_base(base_rotation, tf::Vector3(base_pose_[0], base_pose_[1], 0.));
+	tf::Quaternion torso_rotation;
+	torso_rotation.setRPY(0., (camera_joints_.size()>1 ? camera_joints_[1] : 0.), (camera_joints_.size()>0 ? camera_joints_[0] : 0.));		// pan around z, then tilt around y'
+	const tf::Transform T_torso_lower_to_torso_upper(torso_rotation, tf::Vector3(0., 0., 0.));
+
+	std::vector<tf::StampedTransform> transforms;
+	transforms.push_back(tf::StampedTransform(T_reference_to_base.inverse(), stamp, base_frame_, child_frame_name_));
+	transforms.push_back(tf::StampedTransform(T_base_to_torso_lower_description_, stamp, base_frame_, torso_lower_frame_));
+	transforms.push_back(tf::StampedTransform(T_torso_lower_to_torso_upper, stamp, torso_lower_frame_, torso_upper_frame_));
+	transforms.push_back(tf::StampedTransform(T_torso_upper_to_camera_description_, stamp, torso_upper_frame_, camera_frame_));
+	transforms.push_back(tf::StampedTransform(T_camera_to_camera_optical_, stamp, camera_frame_, camera_optical_frame_));
+	transform_broadcaster_.sendTransform(transforms);
+
+	published_stamp_ = stamp;
+	published_T_base_to_reference_ = T_reference_to_base.inverse();
+	published_T_base_to_camera_optical_ = T_base_to_torso_lower_ * T_torso_lower_to_torso_upper * T_torso_upper_to_camera_ * T_camera_to_camera_optical_;
+
+	// joint states
+	std::vector<std::string> names = camera_joint_names_;
+	std::vector<double> positions = camera_joints_;
+	names.insert(names.end(), arm_joint_names_.begin(), arm_joint_names_.end());
+	positions.insert(positions.end(), arm_joints_.begin(), arm_joints_.begin()+std::min(arm_joints_.size(), arm_joint_names_.size()));
+	camera_state_current_.write(camera_joints_, stamp);
+	arm_state_current_.write(arm_joints_, stamp);
+	sensor_msgs::JointState joint_state;
+	joint_state.header.stamp = stamp;
+	joint_state.name = names;
+	joint_state.position = positions;
+	joint_state_pub_.publish(joint_state);
+}
+
+bool SimulationInterface::getLandmarkInCamera(const std::string& landmark_frame, const tf::Transform& T_base_to_reference, const tf::Transform& T_base_to_camera_optical,
+		tf::Transform& T_camera_optical_to_landmark)
+{
+	// the landmarks are placed relative to the reference frame (e.g. by static transform publishers), independent of the simulated robot
+	try
+	{
+		if (transform_listener_.canTransform(child_frame_name_, landmark_frame, ros::Time(0)) == false)
+			return false;
+		tf::StampedTransform T_reference_to_landmark;
+		transform_listener_.lookupTransform(child_frame_name_, landmark_frame, ros::Time(0), T_reference_to_landmark);
+		T_camera_optical_to_landmark = T_base_to_camera_optical.inverse() * T_base_to_reference * T_reference_to_landmark;
+	}
+	catch (tf::TransformException& ex)
+	{
+		ROS_WARN_THROTTLE(1.0, "%s", ex.what());
+		return false;
+	}
+	return true;
+}
+
+bool SimulationInterface::project(const tf::Vector3& point, cv::Point& pixel) const
+{
+	if (point.z() < 0.05)
+		return false;
+	pixel.x = cvRound(camera_matrix_.at<double>(0,0)*point.x()/point.z() + camera_matrix_.at<double>(0,2));
+	pixel.y = cvRound(camera_matrix_.at<double>(1,1)*point.y()/point.z() + camera_matrix_.at<double>(1,2));
+	return true;
+}
+
+bool SimulationInterface::isVisible(const tf::Vector3& point) const
+{
+	cv::Point pixel;
+	return (project(point, pixel) == true && pixel.x >= 0 && pixel.y >= 0 && pixel.x < image_size_.width && pixel.y < image_size_.height);
+}
+
+void SimulationInterface::publishImage(const ros::Time& stamp, const tf::Transform& T_base_to_reference, const tf::Transform& T_base_to_camera_optical)
+{
+	cv::Mat image(image_size_, CV_8UC3, cv::Scalar(128, 128, 128));
+
+	// checkerboard with one white cell as border, its frame origin is the first inner corner
+	tf::Transform T_camera_optical_to_checkerboard;
+	if (checkerboard_frame_.empty() == false && getLandmarkInCamera(checkerboard_frame_, T_base_to_reference, T_base_to_camera_optical, T_camera_optical_to_checkerboard) == true)
+	{
+		const double c = chessboard_cell_size_;
+		for (int v=-2; v<=chessboard_pattern_size_.height; ++v)
+		{
+			for (int u=-2; u<=chessboard_pattern_size_.width; ++u)
+			{
+				const bool border = (u==-2 || v==-2 || u==chessboard_pattern_size_.width || v==chessboard_pattern_size_.height);
+				const cv::Scalar color = (border==false && (u+v+4)%2==0 ? cv::Scalar(0, 0, 0) : cv::Scalar(255, 255, 255));
+				cv::Point quad[4];
+				bool in_front = true;
+				in_front &= project(T_camera_optical_to_checkerboard * tf::Vector3(u*c, v*c, 0.), quad[0]);
+				in_front &= project(T_camera_optical_to_checkerboard * tf::Vector3((u+1)*c, v*c, 0.), quad[1]);
+				in_front &= project(T_camera_optical_to_checkerboard * tf::Vector3((u+1)*c, (v+1)*c, 0.), quad[2]);
+				in_front &= project(T_camera_optical_to_checkerboard * tf::Vector3(u*c, (v+1)*c, 0.), quad[3]);
+				if (in_front == true)
+					cv::fillConvexPoly(image, quad, 4, color, CV_AA);
+			}
+		}
+	}
+
+	std_msgs::Header header;
+	header.stamp = stamp;
+	header.frame_id = camera_optical_frame_;
+	image_pub_.publish(cv_bridge::CvImage(header, sensor_msgs::image_encodings::BGR8, image).toImageMsg());
+
+	sensor_msgs::CameraInfo camera_info;
+	camera_info.header = header;
+	camera_info.width = image_size_.width;
+	camera_info.height = image_size_.height;
+	camera_info.distortion_model = "plumb_bob";
+	camera_info.D.resize(5, 0.);
+	for (int v=0; v<3; ++v)
+	{
+		for (int u=0; u<3; ++u)
+		{
+			camera_info.K[3*v+u] = camera_matrix_.at<double>(v,u);
+			camera_info.P[4*v+u] = camera_matrix_.at<double>(v,u);
+		}
+		camera_info.R[4*v] = 1.;
+	}
+	camera_info_pub_.publish(camera_info);
+}
+
+bool SimulationInterface::detectFiducialsCallback(cob_object_detection_msgs::DetectObjects::Request& req, cob_object_detection_msgs::DetectObjects::Response& res)
+{
+	ros::Time stamp;
+	tf::Transform T_base_to_reference, T_base_to_camera_optical;
+	{
+		boost::mutex::scoped_lock lock(state_mutex_);
+		stamp = published_stamp_;
+		T_base_to_reference = published_T_base_to_reference_;
+		T_base_to_camera_optical = published_T_base_to_camera_optical_;
+	}
+
+	// every Pi tag frame in TF is a marker, named <marker_frame_base_name>_<id>
+	const std::string prefix = marker_frame_base_name_ + "_";
+	std::vector<std::string> frames;
+	transform_listener_.getFrameStrings(frames);
+	res.object_list.header.stamp = stamp;
+	res.object_list.header.frame_id = camera_optical_frame_;
+	for (size_t i=0; i<frames.size(); ++i)
+	{
+		if (frames[i].compare(0, prefix.size(), prefix) != 0)
+			continue;
+
+		tf::Transform T_camera_optical_to_marker;
+		if (getLandmarkInCamera(frames[i], T_base_to_reference, T_base_to_camera_optical, T_camera_optical_to_marker) == false || isVisible(T_camera_optical_to_marker.getOrigin()) == false)
+			continue;
+
+		// measurement noise on the marker position
+		{
+			boost::mutex::scoped_lock lock(rng_mutex_);
+			T_camera_optical_to_marker.getOrigin() += tf::Vector3(rng_.gaussian(detection_noise_), rng_.gaussian(detection_noise_), rng_.gaussian(detection_noise_));
+		}
+
+		cob_object_detection_msgs::Detection detection;
+		detection.header = res.object_list.header;
+		detection.label = "tag_" + frames[i].substr(prefix.size());
+		detection.detector = "Fiducial_PI";
+		detection.pose.header = res.object_list.header;
+		tf::poseTFToMsg(T_camera_optical_to_marker, detection.pose.pose);
+		res.object_list.detections.push_back(detection);
+	}
+
+	return true;
+}
+
+void SimulationInterface::getParameterNames(std::vector<std::string>& parameter_names)
+{
+	parameter_names.push_back("base_neck");
+	parameter_names.push_back("kinect");
+}
+
+void SimulationInterface::assignNewRobotVelocity(geometry_msgs::Twist new_velocity)
+{
+	boost::mutex::scoped_lock lock(state_mutex_);
+	commanded_velocity_ = new_velocity;
+	commanded_velocity_time_ = ros::Time::now();
+}
+
+void SimulationInterface::assignNewCameraAngles(std_msgs::Float64MultiArray new_angles)
+{
+	boost::mutex::scoped_lock lock(state_mutex_);
+	for (size_t i=0; i<camera_joints_target_.size() && i<new_angles.data.size(); ++i)
+		camera_joints_target_[i] = new_angles.data[i];
+}
+
+JointStateSnapshot SimulationInterface::getCurrentCameraState()
+{
+	return camera_state_current_.read();
+}
+
+void SimulationInterface::assignNewArmJoints(std_msgs::Float64MultiArray new_joint_config)
+{
+	boost::mutex::scoped_lock lock(state_mutex_);
+	if (arm_joints_.size() < new_joint_config.data.size())
+		arm_joints_.resize(new_joint_config.data.size(), 0.);
+	arm_joints_target_ = arm_joints_;
+	for (size_t i=0; i<new_joint_config.data.size(); ++i)
+		arm_joints_target_[i] = new_joint_config.data[i];
+}
+
+JointStateSnapshot SimulationInterface::getCurrentArmState()
+{
+	return arm_state_current_.read();
+}